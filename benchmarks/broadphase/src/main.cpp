@@ -0,0 +1,235 @@
+// Measures finding all overlapping box pairs in a scene where most colliders are static and
+// the rest drift slowly, the case sweep-and-prune is built for, and prints JSON. The spatial
+// hash grid and the dynamic tree replay the same frames for comparison. Every broadphase has
+// to report the same pairs as the brute force loop on every frame, a mismatch fails the run.
+//
+// Usage: broadphase_benchmark [--objects N] [--frames N] [--moving-percent N]
+
+#include "common/benchmark.hpp"
+
+#include "physics/collision.hpp"
+#include "physics/dynamic_tree.hpp"
+#include "physics/spatial_hash_grid.hpp"
+#include "physics/sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace mamba::physics;
+using mamba::benchmark::uniform;
+namespace benchmark = mamba::benchmark;
+
+namespace {
+
+constexpr float TIMESTEP = 1.0f / 60.0f;
+
+struct Options {
+    uint32_t objects = 2000;
+    uint32_t frames = 120;
+    uint32_t moving_percent = 10;
+};
+
+// Box indices, lower first
+using PairList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+struct Scene {
+    float world_size;
+    std::vector<AABB> boxes;
+    std::vector<glm::vec2> velocities; // Zero for static boxes
+    std::vector<uint32_t> moving;      // Indices of the boxes that move
+};
+
+struct Result {
+    std::string name;
+    double setup_ms;
+    benchmark::Timing timing; // Per frame
+    size_t pairs;             // On the last frame
+};
+
+Scene generateScene(const Options& options) {
+    std::mt19937 rng(0x62726f61);
+    Scene scene;
+    // About one neighbour per box
+    scene.world_size = std::sqrt(static_cast<float>(options.objects)) * 24.0f;
+
+    for (uint32_t i = 0; i < options.objects; ++i) {
+        // Mostly small boxes with the odd large one, like scenery around a few walls
+        glm::vec2 size = i % 50 == 0
+                             ? glm::vec2{uniform(rng, 40.0f, 160.0f), uniform(rng, 4.0f, 16.0f)}
+                             : glm::vec2{uniform(rng, 2.0f, 12.0f), uniform(rng, 2.0f, 12.0f)};
+        glm::vec2 center{uniform(rng, 0.0f, scene.world_size),
+                         uniform(rng, 0.0f, scene.world_size)};
+        scene.boxes.push_back({center, size});
+
+        glm::vec2 velocity{0.0f};
+        if (rng() % 100 < options.moving_percent) {
+            velocity = {uniform(rng, -60.0f, 60.0f), uniform(rng, -60.0f, 60.0f)};
+            scene.moving.push_back(i);
+        }
+        scene.velocities.push_back(velocity);
+    }
+    return scene;
+}
+
+// Advances the moving boxes, bouncing them off the world edges
+void step(Scene& scene) {
+    for (uint32_t index : scene.moving) {
+        auto& box = scene.boxes[index];
+        auto& velocity = scene.velocities[index];
+        box.center += velocity * TIMESTEP;
+        for (int axis = 0; axis < 2; ++axis) {
+            if (box.center[axis] < 0.0f || box.center[axis] > scene.world_size)
+                velocity[axis] = -velocity[axis];
+        }
+    }
+}
+
+// Replays the scene from its first frame. `setup` builds the broadphase, `frame` updates it
+// after the moving boxes stepped and appends the overlapping pairs, which are sorted untimed.
+Result measure(std::string name, const Scene& initial, uint32_t frames,
+               std::vector<PairList>& frame_pairs, const std::function<void(const Scene&)>& setup,
+               const std::function<void(const Scene&, PairList&)>& frame) {
+    Scene scene = initial;
+    double setup_ms = benchmark::elapsedMs([&] { setup(scene); });
+
+    std::vector<double> times;
+    frame_pairs.clear();
+    for (uint32_t i = 0; i < frames; ++i) {
+        step(scene);
+        PairList pairs;
+        times.push_back(benchmark::elapsedMs([&] { frame(scene, pairs); }));
+        std::ranges::sort(pairs);
+        frame_pairs.push_back(std::move(pairs));
+    }
+
+    return {std::move(name), setup_ms, benchmark::summarize(std::move(times)),
+            frame_pairs.back().size()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool parsed = benchmark::parseFlags(
+        argc, argv, "broadphase_benchmark [--objects N] [--frames N] [--moving-percent N]",
+        {benchmark::number("--objects", options.objects),
+         benchmark::number("--frames", options.frames),
+         benchmark::number("--moving-percent", options.moving_percent,
+                           [](uint32_t percent) { return percent > 0 && percent <= 100; })});
+    if (!parsed)
+        return 1;
+
+    const Scene scene = generateScene(options);
+    std::vector<PairList> expected, found;
+    std::vector<Result> results;
+
+    results.push_back(measure(
+        "brute_force", scene, options.frames, expected, [](const Scene&) {},
+        [](const Scene& scene, PairList& pairs) {
+            for (uint32_t i = 0; i < scene.boxes.size(); ++i) {
+                for (uint32_t j = i + 1; j < scene.boxes.size(); ++j) {
+                    if (overlaps(scene.boxes[i], scene.boxes[j]))
+                        pairs.emplace_back(i, j);
+                }
+            }
+        }));
+
+    // Each broadphase has to agree with brute force frame for frame
+    auto compare = [&](std::string_view name) {
+        if (found == expected)
+            return true;
+        auto frame = std::ranges::mismatch(found, expected).in1 - found.begin();
+        std::cerr << std::format("{}: pairs differ from brute force on frame {}\n", name, frame);
+        return false;
+    };
+
+    // Ids match box indices, both are filled in order
+    SweepAndPrune sweep_and_prune;
+    results.push_back(measure(
+        "sweep_and_prune", scene, options.frames, found,
+        [&](const Scene& scene) {
+            for (const auto& box : scene.boxes)
+                sweep_and_prune.insert(box);
+            sweep_and_prune.updatePairs();
+        },
+        [&](const Scene& scene, PairList& pairs) {
+            for (uint32_t index : scene.moving)
+                sweep_and_prune.update(index, scene.boxes[index]);
+            sweep_and_prune.updatePairs();
+            sweep_and_prune.forEachPair(
+                [&](SweepAndPrune::Id a, SweepAndPrune::Id b) { pairs.emplace_back(a, b); });
+        }));
+    bool valid = compare("sweep_and_prune");
+
+    SpatialHashGrid grid({.cell_size = 16.0f, .bucket_count = options.objects * 2});
+    results.push_back(measure(
+        "spatial_hash_grid", scene, options.frames, found,
+        [&](const Scene& scene) {
+            for (const auto& box : scene.boxes)
+                grid.insert(box);
+        },
+        [&](const Scene& scene, PairList& pairs) {
+            for (uint32_t index : scene.moving)
+                grid.update(index, scene.boxes[index]);
+            grid.forEachPair([&](SpatialHashGrid::Id a, SpatialHashGrid::Id b) {
+                pairs.push_back(std::minmax(a, b));
+            });
+        }));
+    valid &= compare("spatial_hash_grid");
+
+    // The tree has no pair query, each box queries its own bounds and keeps higher indices.
+    // Candidates come from fat boxes and are confirmed on the real ones.
+    DynamicTree tree;
+    std::vector<DynamicTree::Id> tree_ids;
+    results.push_back(measure(
+        "dynamic_tree", scene, options.frames, found,
+        [&](const Scene& scene) {
+            for (uint32_t i = 0; i < scene.boxes.size(); ++i)
+                tree_ids.push_back(tree.insert(scene.boxes[i], i));
+        },
+        [&](const Scene& scene, PairList& pairs) {
+            for (uint32_t index : scene.moving)
+                tree.update(tree_ids[index], scene.boxes[index],
+                            scene.velocities[index] * TIMESTEP);
+            for (uint32_t i = 0; i < scene.boxes.size(); ++i) {
+                tree.query(scene.boxes[i], [&](DynamicTree::Id id) {
+                    uint32_t other = tree.getUserData(id);
+                    if (other > i && overlaps(scene.boxes[i], scene.boxes[other]))
+                        pairs.emplace_back(i, other);
+                });
+            }
+        }));
+    valid &= compare("dynamic_tree");
+
+    if (!valid)
+        return 1;
+
+    benchmark::JsonWriter json;
+    json.beginObject();
+    json.field("objects", scene.boxes.size());
+    json.field("moving", scene.moving.size());
+    json.field("frames", options.frames);
+    json.beginArray("broadphases");
+    for (const auto& result : results) {
+        json.beginObject();
+        json.field("name", result.name);
+        json.field("setup_ms", result.setup_ms);
+        json.field("best_ms", result.timing.best_ms);
+        json.field("median_ms", result.timing.median_ms);
+        json.field("pairs", result.pairs);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    std::cout << json.str();
+    return 0;
+}
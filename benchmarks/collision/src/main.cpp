@@ -0,0 +1,265 @@
+// Measures the pair tests of physics/collision.hpp in millions of tests per second, one pair
+// at a time (scalar) and through the kernels of physics/collision_batch.hpp (batched), and
+// prints JSON.
+// The inputs mix random pairs with the edge cases the game hits: circle centers inside boxes,
+// zero-size boxes, touching edges. Batched results are checked against the scalar ones before
+// anything is reported, a mismatch fails the run.
+// The kernels are the ones the build targets (see MAMBA_AVX2) and are named in the output;
+// collision_benchmark_avx2 always uses the AVX2 ones and exits with 77 on CPUs without AVX2.
+//
+// Usage: collision_benchmark [--pairs N] [--repeats N]
+
+#include "common/benchmark.hpp"
+
+#include "physics/collision.hpp"
+#include "physics/collision_batch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(MAMBA_PHYSICS_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace mamba::physics;
+using mamba::benchmark::uniform;
+namespace benchmark = mamba::benchmark;
+
+namespace {
+
+struct Options {
+    uint32_t pairs = 1 << 20;
+    uint32_t repeats = 15;
+};
+
+// Per-pair inputs, laid out the way game code holds them
+struct Pairs {
+    std::vector<AABB> boxes_a;
+    std::vector<AABB> boxes_b;
+    std::vector<Circle> circles_a;
+    std::vector<Circle> circles_b;
+    std::vector<glm::vec2> points;
+};
+
+struct Result {
+    std::string name;
+    benchmark::Timing timing;
+    double mtests_per_second; // From the median
+    size_t hits;
+};
+
+Pairs generatePairs(uint32_t count) {
+    std::mt19937 rng(0x636f6c6c);
+    Pairs pairs;
+
+    // Dense enough that roughly a third of the pairs touch, so neither outcome is predictable
+    auto random_box = [&] {
+        return AABB{{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)},
+                    {uniform(rng, 0.0f, 40.0f), uniform(rng, 0.0f, 40.0f)}};
+    };
+    auto random_circle = [&] {
+        return Circle{{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)},
+                      uniform(rng, 0.0f, 20.0f)};
+    };
+
+    for (uint32_t i = 0; i < count; ++i) {
+        AABB a = random_box(), b = random_box();
+        Circle c = random_circle(), d = random_circle();
+        glm::vec2 point{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)};
+
+        switch (i % 16) {
+        case 0: // Circle center inside the box
+            c.center = b.center;
+            break;
+        case 1: // Zero-size boxes
+            a.size = {0.0f, 0.0f};
+            b.size = {0.0f, 0.0f};
+            break;
+        case 2: // Edges exactly touching
+            a.center.x = b.center.x + (a.size.x + b.size.x) / 2.0f;
+            a.center.y = b.center.y;
+            point = b.center + b.size / 2.0f;
+            break;
+        case 3: // Zero radius
+            c.radius = 0.0f;
+            break;
+        }
+
+        pairs.boxes_a.push_back(a);
+        pairs.boxes_b.push_back(b);
+        pairs.circles_a.push_back(c);
+        pairs.circles_b.push_back(d);
+        pairs.points.push_back(point);
+    }
+    return pairs;
+}
+
+template <typename Set, typename Shape>
+Set toSet(const std::vector<Shape>& shapes) {
+    Set set;
+    set.reserve(shapes.size());
+    for (const auto& shape : shapes)
+        set.push_back(shape);
+    return set;
+}
+
+// Runs `kernel` over every pair `repeats` times, the kernel fills `out` with one byte per pair
+Result measure(std::string name, uint32_t repeats, std::vector<uint8_t>& out,
+               const std::function<void(std::vector<uint8_t>&)>& kernel) {
+    std::vector<double> times;
+    for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        times.push_back(benchmark::elapsedMs([&] { kernel(out); }));
+
+    auto timing = benchmark::summarize(std::move(times));
+    size_t hits = std::ranges::count_if(out, [](uint8_t hit) { return hit != 0; });
+    return {std::move(name), timing, out.size() / timing.median_ms / 1000.0, hits};
+}
+
+// An AVX2 build would stop at the first kernel on CPUs without it
+bool cpuRunsKernels() {
+#if defined(MAMBA_PHYSICS_AVX2) && defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#elif defined(MAMBA_PHYSICS_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!benchmark::parseFlags(argc, argv, "collision_benchmark [--pairs N] [--repeats N]",
+                               {benchmark::number("--pairs", options.pairs),
+                                benchmark::number("--repeats", options.repeats)}))
+        return 1;
+
+    if (!cpuRunsKernels()) {
+        std::cerr << std::format("This CPU cannot run the {} kernels\n", BATCH_KERNELS);
+        return 77;
+    }
+
+    const auto pairs = generatePairs(options.pairs);
+    const auto boxes_a = toSet<BoxSet>(pairs.boxes_a);
+    const auto boxes_b = toSet<BoxSet>(pairs.boxes_b);
+    const auto circles_a = toSet<CircleSet>(pairs.circles_a);
+    const auto circles_b = toSet<CircleSet>(pairs.circles_b);
+    const auto points = toSet<PointSet>(pairs.points);
+
+    const size_t count = options.pairs;
+    std::vector<uint8_t> scalar(count), batched(count);
+    std::vector<Result> results;
+
+    // Scalar and batched runs of the same test sit next to each other, and their outputs
+    // have to agree pair for pair
+    auto compare = [&](std::string_view test) {
+        if (scalar == batched)
+            return true;
+        auto mismatch = std::ranges::mismatch(scalar, batched).in1 - scalar.begin();
+        std::cerr << std::format("{}: batched result differs from scalar at pair {}\n", test,
+                                 mismatch);
+        return false;
+    };
+
+    results.push_back(measure("overlaps_aabb_aabb", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = overlaps(pairs.boxes_a[i], pairs.boxes_b[i]);
+    }));
+    results.push_back(measure("overlaps_aabb_aabb_batched", options.repeats, batched,
+                              [&](auto& out) {
+                                  overlaps(boxes_a, boxes_b, out);
+                              }));
+    bool valid = compare("overlaps_aabb_aabb");
+
+    results.push_back(measure("overlaps_circle_circle", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = overlaps(pairs.circles_a[i], pairs.circles_b[i]);
+    }));
+    results.push_back(measure("overlaps_circle_circle_batched", options.repeats, batched,
+                              [&](auto& out) {
+                                  overlaps(circles_a, circles_b, out);
+                              }));
+    valid &= compare("overlaps_circle_circle");
+
+    results.push_back(measure("overlaps_circle_aabb", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = overlaps(pairs.circles_a[i], pairs.boxes_b[i]);
+    }));
+    results.push_back(measure("overlaps_circle_aabb_batched", options.repeats, batched,
+                              [&](auto& out) {
+                                  overlaps(circles_a, boxes_b, out);
+                              }));
+    valid &= compare("overlaps_circle_aabb");
+
+    results.push_back(measure("contains_aabb_point", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = contains(pairs.boxes_b[i], pairs.points[i]);
+    }));
+    results.push_back(measure("contains_aabb_point_batched", options.repeats, batched,
+                              [&](auto& out) {
+                                  contains(boxes_b, points, out);
+                              }));
+    valid &= compare("contains_aabb_point");
+
+    // One collider against all of a set, the shape of a narrowphase after a broadphase query
+    const Circle& circle = pairs.circles_a.front();
+    results.push_back(measure("overlaps_circle_many_aabb", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = overlaps(circle, pairs.boxes_b[i]);
+    }));
+    results.push_back(measure("overlaps_circle_many_aabb_batched", options.repeats, batched,
+                              [&](auto& out) { overlaps(circle, boxes_b, out); }));
+    valid &= compare("overlaps_circle_many_aabb");
+
+    const AABB& box = pairs.boxes_b.front();
+    results.push_back(measure("contains_aabb_many_point", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = contains(box, pairs.points[i]);
+    }));
+    results.push_back(measure("contains_aabb_many_point_batched", options.repeats, batched,
+                              [&](auto& out) { contains(box, points, out); }));
+    valid &= compare("contains_aabb_many_point");
+
+    // No batched form, measured for the baseline
+    results.push_back(measure("collides_circle_aabb", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = collides(pairs.circles_a[i], pairs.boxes_b[i]).has_value();
+    }));
+    results.push_back(measure("contains_circle_point", options.repeats, scalar, [&](auto& out) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = contains(pairs.circles_b[i], pairs.points[i]);
+    }));
+
+    if (!valid)
+        return 1;
+
+    benchmark::JsonWriter json;
+    json.beginObject();
+    json.field("kernels", BATCH_KERNELS);
+    json.field("pairs", count);
+    json.field("repeats", options.repeats);
+    json.beginArray("tests");
+    for (const auto& result : results) {
+        json.beginObject();
+        json.field("name", result.name);
+        json.field("best_ms", result.timing.best_ms);
+        json.field("median_ms", result.timing.median_ms);
+        json.field("mtests_per_second", result.mtests_per_second, 2);
+        json.field("hits", result.hits);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    std::cout << json.str();
+    return 0;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+// Helpers shared by the benchmarks: seeded random numbers, command line flags, timing
+// summaries and the JSON reports. Only Release builds give meaningful numbers.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace mamba::benchmark {
+
+// std::mt19937 output is fixed by the standard, unlike the distributions built on it, so the
+// generated scenes are the same on every platform
+inline float uniform(std::mt19937& rng, float min, float max) {
+    return min + (max - min) * static_cast<float>(rng()) / static_cast<float>(rng.max());
+}
+
+/// A command line flag, `--name value` or a switch without a value
+struct Flag {
+    std::string_view name;
+    std::function<bool(std::string_view)> parse; // Returns false for invalid values
+    bool takes_value = true;
+};
+
+// Positive numbers unless `valid` says otherwise
+template <typename T>
+Flag number(std::string_view name, T& value,
+            std::type_identity_t<std::function<bool(T)>> valid = [](T parsed) {
+                return parsed > T{0};
+            }) {
+    return {name, [&value, valid = std::move(valid)](std::string_view input) {
+                const char* last = input.data() + input.size();
+                auto [end, error] = std::from_chars(input.data(), last, value);
+                return error == std::errc{} && end == last && valid(value);
+            }};
+}
+
+inline Flag text(std::string_view name, std::string& value) {
+    return {name, [&value](std::string_view input) {
+                value = input;
+                return !value.empty();
+            }};
+}
+
+inline Flag toggle(std::string_view name, bool& value) {
+    return {name,
+            [&value](std::string_view) {
+                value = true;
+                return true;
+            },
+            false};
+}
+
+// Applies the flags in any order. Unknown flags, missing or invalid values print the usage and
+// return false.
+inline bool parseFlags(int argc, char** argv, std::string_view usage,
+                       std::initializer_list<Flag> flags) {
+    for (int i = 1; i < argc; ++i) {
+        auto flag = std::ranges::find(flags, std::string_view(argv[i]), &Flag::name);
+        bool ok = flag != flags.end();
+        if (ok && flag->takes_value)
+            ok = ++i < argc && flag->parse(argv[i]);
+        else if (ok)
+            ok = flag->parse({});
+
+        if (!ok) {
+            std::cerr << "Usage: " << usage << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Best and median of repeated runs, the median is what the reports compare
+struct Timing {
+    double best_ms;
+    double median_ms;
+};
+
+// Runs `work` once and returns how long it took
+template <typename F>
+double elapsedMs(F&& work) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    work();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+inline Timing summarize(std::vector<double> times_ms) {
+    std::ranges::sort(times_ms);
+    return {times_ms.front(), times_ms[times_ms.size() / 2]};
+}
+
+/// Builds the reports: the top level object and its arrays get one entry per line, anything
+/// nested deeper stays on the line of its array entry. Keys are left out inside arrays.
+class JsonWriter {
+  public:
+    void beginObject(std::string_view key = {}) { open(key, '{'); }
+    void endObject() { close('}'); }
+    void beginArray(std::string_view key) { open(key, '['); }
+    void endArray() { close(']'); }
+
+    void field(std::string_view key, std::string_view value) {
+        beginValue(key);
+        m_json += std::format("\"{}\"", escape(value));
+    }
+    void field(std::string_view key, const char* value) { field(key, std::string_view(value)); }
+    void field(std::string_view key, bool value) {
+        beginValue(key);
+        m_json += value ? "true" : "false";
+    }
+    void field(std::string_view key, std::nullptr_t) {
+        beginValue(key);
+        m_json += "null";
+    }
+    template <std::integral T>
+    void field(std::string_view key, T value) {
+        beginValue(key);
+        m_json += std::format("{}", value);
+    }
+    void field(std::string_view key, double value, int precision = 4) {
+        beginValue(key);
+        m_json += std::format("{:.{}f}", value, precision);
+    }
+
+    const std::string& str() const { return m_json; }
+
+  private:
+    struct Level {
+        bool multiline;
+        bool empty;
+    };
+
+    static std::string escape(std::string_view text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    void newline(size_t depth) {
+        m_json += '\n';
+        m_json.append(2 * depth, ' ');
+    }
+
+    // Separates the value from the previous one in the same container
+    void beginValue(std::string_view key) {
+        if (m_levels.empty())
+            return;
+        auto& level = m_levels.back();
+        if (!level.empty)
+            m_json += level.multiline ? "," : ", ";
+        if (level.multiline)
+            newline(m_levels.size());
+        level.empty = false;
+        if (!key.empty())
+            m_json += std::format("\"{}\": ", escape(key));
+    }
+
+    void open(std::string_view key, char bracket) {
+        beginValue(key);
+        m_json += bracket;
+        m_levels.push_back({m_levels.size() < 2, true});
+    }
+
+    void close(char bracket) {
+        Level level = m_levels.back();
+        m_levels.pop_back();
+        if (level.multiline && !level.empty)
+            newline(m_levels.size());
+        m_json += bracket;
+        if (m_levels.empty())
+            m_json += '\n';
+    }
+
+    std::string m_json;
+    std::vector<Level> m_levels;
+};
+
+} // namespace mamba::benchmark
@@ -0,0 +1,227 @@
+// Renders a set of generated stress scenes through Renderer2D and reports per-frame CPU and
+// GPU time, draw calls and upload volume as JSON. Runs headless unless --windowed is given.
+//
+// Usage: renderer_benchmark [--frames N] [--warmup N] [--scale F] [--output file.json]
+//                           [--windowed]
+
+#include "scenes.hpp"
+
+#include "common/benchmark.hpp"
+
+#include "app.hpp"
+#include "frame_pacing.hpp"
+#include "layer.hpp"
+#include "renderer/camera.hpp"
+#include "renderer/gpu_timer.hpp"
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace benchmark = mamba::benchmark;
+
+namespace {
+
+constexpr std::string_view USAGE =
+    "renderer_benchmark [--frames N] [--warmup N] [--scale F] [--output file.json] [--windowed]";
+
+constexpr uint32_t WIDTH = 1280;
+constexpr uint32_t HEIGHT = 720;
+// Above the sixteen texture slots of a batch
+constexpr uint32_t TEXTURE_COUNT = 24;
+
+struct Options {
+    uint32_t frames = 300;
+    uint32_t warmup = 30;
+    float scale = 1.0f;
+    std::string output;
+    bool windowed = false;
+};
+
+struct SceneResult {
+    std::string name;
+    uint32_t items;
+    mamba::FrameTimeSummary cpu;
+    std::optional<mamba::FrameTimeSummary> gpu;
+    mamba::Renderer::RendererStats stats; // Of the last measured frame, every frame is the same
+};
+
+void writeSummary(benchmark::JsonWriter& json, std::string_view key,
+                  const std::optional<mamba::FrameTimeSummary>& summary) {
+    if (!summary) {
+        json.field(key, nullptr);
+        return;
+    }
+    json.beginObject(key);
+    json.field("mean", summary->mean_ms);
+    json.field("p99", summary->p99_ms);
+    json.field("max", summary->max_ms);
+    json.endObject();
+}
+
+std::string toJson(const Options& options, std::string_view gl_renderer,
+                   const std::vector<SceneResult>& results) {
+    benchmark::JsonWriter json;
+    json.beginObject();
+    json.field("renderer", gl_renderer);
+    json.field("width", WIDTH);
+    json.field("height", HEIGHT);
+    json.field("frames", options.frames);
+    json.field("scale", options.scale);
+    json.beginArray("scenes");
+    for (const auto& result : results) {
+        json.beginObject();
+        json.field("name", result.name);
+        json.field("items", result.items);
+        writeSummary(json, "cpu_ms", result.cpu);
+        writeSummary(json, "gpu_ms", result.gpu);
+        json.field("draw_calls", result.stats.draw_calls);
+        json.field("bytes_uploaded", result.stats.bytes_uploaded);
+        json.field("quads", result.stats.quads);
+        json.field("circles", result.stats.circles);
+        json.field("glyphs", result.stats.glyphs);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    return json.str();
+}
+
+/// Draws each scene for warmup + measured frames, then closes the app
+class BenchmarkLayer : public mamba::Layer {
+  public:
+    explicit BenchmarkLayer(const Options& options)
+        : m_options(options), m_camera(0.0f, WIDTH, 0.0f, HEIGHT), m_cpu_times(options.frames),
+          m_gpu_times(options.frames) {}
+
+    void onAttach() override {
+        m_font = mamba::Renderer::Font::create();
+        m_resources = {createSceneTextures(TEXTURE_COUNT), &*m_font,
+                       {static_cast<float>(WIDTH), static_cast<float>(HEIGHT)}};
+        m_scenes = createScenes(m_resources, m_options.scale);
+        m_gpu_timer.emplace();
+    }
+
+    void onRender(float) override {
+        if (m_scene >= m_scenes.size())
+            return;
+
+        using Clock = std::chrono::steady_clock;
+        auto& renderer = getApp()->getRenderer();
+        bool measured = m_frame >= m_options.warmup;
+
+        m_gpu_timer->begin();
+        auto start = Clock::now();
+
+        renderer.resetStats();
+        renderer.setClearColor({0.1f, 0.1f, 0.15f, 1.0f});
+        renderer.clear();
+        renderer.begin(m_camera);
+        m_scenes[m_scene].draw(renderer);
+        renderer.end();
+
+        auto cpu_time = Clock::now() - start;
+        m_gpu_timer->end();
+
+        if (measured)
+            m_cpu_times.record(cpu_time);
+        // Timer results trail behind, the first `warmup` of each scene are dropped
+        recordGpuTimes(m_gpu_timer->collect());
+
+        if (++m_frame == m_options.warmup + m_options.frames)
+            finishScene();
+    }
+
+    const std::vector<SceneResult>& getResults() const { return m_results; }
+
+  private:
+    void recordGpuTimes(const std::vector<double>& times) {
+        for (double ms : times) {
+            if (m_gpu_skip > 0) {
+                --m_gpu_skip;
+                continue;
+            }
+            m_gpu_times.record(std::chrono::duration<double, std::milli>(ms));
+            ++m_gpu_samples;
+        }
+    }
+
+    void finishScene() {
+        recordGpuTimes(m_gpu_timer->collect(true));
+
+        const auto& scene = m_scenes[m_scene];
+        m_results.push_back({scene.name, scene.items, m_cpu_times.summarize(),
+                             m_gpu_samples ? std::optional(m_gpu_times.summarize()) : std::nullopt,
+                             getApp()->getRenderer().getStats()});
+        std::cerr << std::format("{}: {:.3f} ms cpu\n", scene.name, m_results.back().cpu.mean_ms);
+
+        m_cpu_times.reset();
+        m_gpu_times.reset();
+        m_gpu_samples = 0;
+        m_gpu_skip = m_options.warmup;
+        m_frame = 0;
+        if (++m_scene == m_scenes.size())
+            getApp()->close();
+    }
+
+    Options m_options;
+    mamba::OrthographicCamera m_camera;
+    std::optional<mamba::Renderer::Font> m_font;
+    SceneResources m_resources;
+    std::vector<Scene> m_scenes;
+    std::optional<mamba::Renderer::GpuTimer> m_gpu_timer;
+
+    size_t m_scene{0};
+    uint32_t m_frame{0};
+    mamba::FrameStats m_cpu_times;
+    mamba::FrameStats m_gpu_times;
+    uint32_t m_gpu_samples{0};
+    uint32_t m_gpu_skip{m_options.warmup};
+    std::vector<SceneResult> m_results;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool parsed = benchmark::parseFlags(
+        argc, argv, USAGE,
+        {benchmark::number("--frames", options.frames),
+         benchmark::number("--warmup", options.warmup, [](uint32_t) { return true; }),
+         benchmark::number("--scale", options.scale), benchmark::text("--output", options.output),
+         benchmark::toggle("--windowed", options.windowed)});
+    if (!parsed)
+        return 1;
+
+    mamba::App app({.title = "Renderer benchmark",
+                    .width = WIDTH,
+                    .height = HEIGHT,
+                    .vsync = mamba::VSyncMode::Off,
+                    .headless = !options.windowed});
+    app.pushLayer<BenchmarkLayer>(options);
+    app.run();
+
+    const auto* gl_renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    auto json = toJson(options, gl_renderer ? gl_renderer : "unknown",
+                       app.getLayer<BenchmarkLayer>()->getResults());
+
+    if (options.output.empty()) {
+        std::cout << json;
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    file << json;
+    if (!file) {
+        std::cerr << "Failed to write " << options.output << "\n";
+        return 1;
+    }
+    return 0;
+}
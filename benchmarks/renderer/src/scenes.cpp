@@ -0,0 +1,200 @@
+#include "scenes.hpp"
+
+#include "common/benchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string_view>
+
+using mamba::Renderer::Renderer2D;
+using mamba::Renderer::Texture;
+using mamba::benchmark::uniform;
+
+namespace {
+
+constexpr uint32_t SEED = 0x6d616d62;
+
+constexpr std::string_view TEXT_LINE =
+    "The quick brown fox jumps over the lazy dog 0123456789 !?#%&*()[]{}<>+-=/\\|";
+constexpr float TEXT_LINE_HEIGHT = 14.0f;
+
+glm::vec4 randomColor(std::mt19937& rng) {
+    return {uniform(rng, 0.2f, 1.0f), uniform(rng, 0.2f, 1.0f), uniform(rng, 0.2f, 1.0f), 1.0f};
+}
+
+uint32_t scaled(uint32_t count, float scale) {
+    return std::max(1u, static_cast<uint32_t>(std::lround(count * scale)));
+}
+
+struct Sprite {
+    glm::vec2 position;
+    glm::vec2 size;
+    glm::vec4 color;
+    uint32_t texture;
+};
+
+std::vector<Sprite> randomSprites(std::mt19937& rng, uint32_t count, uint32_t texture_count,
+                                  glm::vec2 extent, float min_size, float max_size) {
+    std::vector<Sprite> sprites(count);
+    for (auto& sprite : sprites) {
+        float size = uniform(rng, min_size, max_size);
+        sprite = {{uniform(rng, 0.0f, extent.x), uniform(rng, 0.0f, extent.y)},
+                  {size, size},
+                  randomColor(rng),
+                  static_cast<uint32_t>(rng() % texture_count)};
+    }
+    return sprites;
+}
+
+glm::mat4 transformOf(glm::vec2 position, glm::vec2 size) {
+    glm::mat4 transform(1.0f);
+    transform = glm::translate(transform, glm::vec3(position, 0.0f));
+    return glm::scale(transform, glm::vec3(size, 1.0f));
+}
+
+Scene texturedQuads(const SceneResources& resources, float scale) {
+    // Stays within one batch's texture slots, measures raw quad throughput
+    constexpr uint32_t TEXTURES = 8;
+
+    std::mt19937 rng(SEED);
+    auto sprites = std::make_shared<std::vector<Sprite>>(
+        randomSprites(rng, scaled(50000, scale), TEXTURES, resources.extent, 4.0f, 32.0f));
+
+    return {"textured_quads", static_cast<uint32_t>(sprites->size()),
+            [sprites, &textures = resources.textures](Renderer2D& renderer) {
+                for (const auto& sprite : *sprites)
+                    renderer.drawQuad(sprite.position, sprite.size, textures[sprite.texture],
+                                      sprite.color);
+            }};
+}
+
+Scene circles(const SceneResources& resources, float scale) {
+    std::mt19937 rng(SEED + 1);
+    auto sprites = std::make_shared<std::vector<Sprite>>(
+        randomSprites(rng, scaled(20000, scale), 1, resources.extent, 4.0f, 32.0f));
+
+    return {"circles", static_cast<uint32_t>(sprites->size()), [sprites](Renderer2D& renderer) {
+                for (const auto& sprite : *sprites)
+                    renderer.drawCircle(transformOf(sprite.position, sprite.size), sprite.color);
+            }};
+}
+
+Scene glyphs(const SceneResources& resources, float scale) {
+    uint32_t lines = scaled(400, scale);
+    const auto* font = resources.font;
+    glm::vec2 extent = resources.extent;
+
+    return {"glyphs", static_cast<uint32_t>(lines * TEXT_LINE.size()),
+            [lines, font, extent](Renderer2D& renderer) {
+                auto rows = static_cast<uint32_t>(extent.y / TEXT_LINE_HEIGHT);
+                for (uint32_t line = 0; line < lines; ++line) {
+                    // Lines past the bottom wrap into further columns
+                    glm::vec2 position{(line / rows) * 16.0f,
+                                       extent.y - (line % rows + 1) * TEXT_LINE_HEIGHT};
+                    renderer.drawText(TEXT_LINE, *font, position, TEXT_LINE_HEIGHT,
+                                      glm::vec4(1.0f));
+                }
+            }};
+}
+
+Scene mixedOrder(const SceneResources& resources, float scale) {
+    std::mt19937 rng(SEED + 2);
+    auto count = scaled(15000, scale);
+    // More textures than slots, so batches keep breaking the way an unsorted scene does
+    auto texture_count = static_cast<uint32_t>(resources.textures.size());
+    auto sprites = std::make_shared<std::vector<Sprite>>(
+        randomSprites(rng, count, texture_count, resources.extent, 4.0f, 32.0f));
+
+    return {"mixed_order", count,
+            [sprites, &textures = resources.textures, font = resources.font](Renderer2D& renderer) {
+                for (size_t i = 0; i < sprites->size(); ++i) {
+                    const auto& sprite = (*sprites)[i];
+                    switch (i % 4) {
+                    case 0:
+                    case 1:
+                        renderer.drawQuad(sprite.position, sprite.size, textures[sprite.texture],
+                                          sprite.color);
+                        break;
+                    case 2:
+                        renderer.drawCircle(transformOf(sprite.position, sprite.size),
+                                            sprite.color);
+                        break;
+                    case 3:
+                        renderer.drawText("42", *font, sprite.position, sprite.size.y,
+                                          sprite.color);
+                        break;
+                    }
+                }
+            }};
+}
+
+Scene breakoutGrid(const SceneResources& resources, float scale) {
+    static constexpr std::array<glm::vec4, 5> ROW_COLORS = {{
+        {1.0f, 0.3f, 0.3f, 1.0f},
+        {1.0f, 0.6f, 0.2f, 1.0f},
+        {1.0f, 1.0f, 0.3f, 1.0f},
+        {0.3f, 1.0f, 0.3f, 1.0f},
+        {0.3f, 0.6f, 1.0f, 1.0f},
+    }};
+
+    auto columns = scaled(64, std::sqrt(scale));
+    auto rows = scaled(32, std::sqrt(scale));
+    glm::vec2 extent = resources.extent;
+    glm::vec2 cell{extent.x / columns, extent.y * 0.6f / rows};
+    const auto* font = resources.font;
+
+    return {"breakout_grid", columns * rows + 2,
+            [=](Renderer2D& renderer) {
+                for (uint32_t row = 0; row < rows; ++row) {
+                    for (uint32_t column = 0; column < columns; ++column) {
+                        glm::vec2 position{(column + 0.5f) * cell.x,
+                                           extent.y - (row + 0.5f) * cell.y};
+                        renderer.drawQuad(position, cell - 2.0f, ROW_COLORS[row % 5]);
+                    }
+                }
+                renderer.drawQuad({extent.x / 2.0f, 40.0f}, {100.0f, 20.0f},
+                                  {0.2f, 0.6f, 1.0f, 1.0f});
+                renderer.drawCircle(transformOf({extent.x / 2.0f, 70.0f}, {20.0f, 20.0f}),
+                                    glm::vec4(1.0f));
+                renderer.drawTextFormat(*font, {10.0f, 10.0f}, 32.0f, glm::vec4(1.0f),
+                                        "Score: {}", rows * columns * 10);
+            }};
+}
+
+} // namespace
+
+std::vector<Texture> createSceneTextures(uint32_t count) {
+    constexpr int SIZE = 64;
+
+    std::vector<Texture> textures;
+    std::vector<uint8_t> pixels(SIZE * SIZE * 4);
+    for (uint32_t i = 0; i < count; ++i) {
+        // Checkerboards with a distinct tint each, so a wrong slot is visible in captures
+        glm::vec3 tint{(i * 53 % 256) / 255.0f, (i * 97 % 256) / 255.0f, (i * 151 % 256) / 255.0f};
+        for (int y = 0; y < SIZE; ++y) {
+            for (int x = 0; x < SIZE; ++x) {
+                float shade = ((x / 8 + y / 8) % 2) ? 1.0f : 0.5f;
+                uint8_t* texel = &pixels[(y * SIZE + x) * 4];
+                texel[0] = static_cast<uint8_t>(255 * shade * tint.r);
+                texel[1] = static_cast<uint8_t>(255 * shade * tint.g);
+                texel[2] = static_cast<uint8_t>(255 * shade * tint.b);
+                texel[3] = 255;
+            }
+        }
+        textures.push_back(Texture::create(pixels.data(), SIZE, SIZE, 4));
+    }
+    return textures;
+}
+
+std::vector<Scene> createScenes(const SceneResources& resources, float scale) {
+    std::vector<Scene> scenes;
+    scenes.push_back(texturedQuads(resources, scale));
+    scenes.push_back(circles(resources, scale));
+    scenes.push_back(glyphs(resources, scale));
+    scenes.push_back(mixedOrder(resources, scale));
+    scenes.push_back(breakoutGrid(resources, scale));
+    return scenes;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "renderer/font.hpp"
+#include "renderer/renderer.hpp"
+#include "renderer/texture.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct SceneResources {
+    std::vector<mamba::Renderer::Texture> textures;
+    const mamba::Renderer::Font* font;
+    glm::vec2 extent; // World size the camera covers, origin bottom left
+};
+
+/// A fixed set of draw calls issued every frame. Generated from a fixed seed, so every run
+/// and every machine draws exactly the same thing.
+struct Scene {
+    std::string name;
+    uint32_t items; // Objects drawn per frame
+    std::function<void(mamba::Renderer::Renderer2D&)> draw;
+};
+
+// Textures that scenes draw from, more than a single batch has slots for
+std::vector<mamba::Renderer::Texture> createSceneTextures(uint32_t count);
+
+// `scale` multiplies every item count
+std::vector<Scene> createScenes(const SceneResources& resources, float scale);
@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <cmath>
-#include <format>
 
 #include "app.hpp"
 #include "input_events.hpp"
@@ -21,6 +20,11 @@ static const glm::vec4 PADDLE_COLOR{0.2f, 0.6f, 1.0f, 1.0f};
 static const glm::vec4 BALL_COLOR{1.0f, 1.0f, 1.0f, 1.0f};
 static const glm::vec4 BACKGROUND_COLOR{0.1f, 0.1f, 0.15f, 1.0f};
 
+// Bounces handled within one tick, movement left after the last one is dropped
+static constexpr int MAX_BALL_IMPACTS = 4;
+// Gap left between the ball and what it hit, so the overlap tests do not count it again
+static constexpr float CONTACT_GAP = 0.01f;
+
 BreakoutLayer::BreakoutLayer() { m_font = mamba::Renderer::Font::create(); }
 
 void BreakoutLayer::initGame() {
@@ -29,11 +33,13 @@ void BreakoutLayer::initGame() {
     m_score = 0;
     m_lives = 3;
     m_bricks.clear();
+    m_brick_grid.clear();
 
     // Setup paddle at bottom center
     m_paddle.position = {m_screen_width / 2.0f, 40.0f};
     m_paddle.size = {100.0f, 20.0f};
     m_paddle.speed = 500.0f;
+    m_paddle_previous = m_paddle.position;
 
     // Setup ball on paddle
     resetBall();
@@ -58,6 +64,7 @@ void BreakoutLayer::initGame() {
             brick.destroyed = false;
             brick.hits = 1;
             m_bricks.push_back(brick);
+            m_brick_grid.insert(mamba::physics::AABB{brick.position, brick.size});
         }
     }
 }
@@ -69,9 +76,11 @@ void BreakoutLayer::resetBall() {
     // Ball sits on top of paddle
     m_ball.position = {m_paddle.position.x,
                        m_paddle.position.y + m_paddle.size.y / 2.0f + m_ball.radius};
+    // Teleported, nothing to blend from
+    m_ball_previous = m_ball.position;
 }
 
-void BreakoutLayer::onUpdate(float dt) {
+void BreakoutLayer::onUpdate(float) {
     // Update screen size
     glm::vec2 fb_size = getApp()->getWindow().getFrameBufferSize();
     bool size_changed = (m_screen_width != fb_size.x || m_screen_height != fb_size.y);
@@ -87,6 +96,11 @@ void BreakoutLayer::onUpdate(float dt) {
             initGame();
         }
     }
+}
+
+void BreakoutLayer::onFixedUpdate(float dt) {
+    m_paddle_previous = m_paddle.position;
+    m_ball_previous = m_ball.position;
 
     if (m_state != GameState::Playing) {
         return;
@@ -97,9 +111,7 @@ void BreakoutLayer::onUpdate(float dt) {
     checkCollisions();
 
     // Check win condition
-    bool all_destroyed =
-        std::all_of(m_bricks.begin(), m_bricks.end(), [](const Brick& b) { return b.destroyed; });
-    if (all_destroyed) {
+    if (m_brick_grid.size() == 0) {
         m_state = GameState::Win;
     }
 }
@@ -129,7 +141,7 @@ void BreakoutLayer::updateBall(float dt) {
         return;
     }
 
-    m_ball.position += m_ball.velocity * dt;
+    moveBall(dt);
 
     // Wall collisions
     // Left wall
@@ -158,6 +170,57 @@ void BreakoutLayer::updateBall(float dt) {
     }
 }
 
+// Sweeps the ball along its path and stops it at the first brick or paddle in the way, so a
+// fast ball cannot pass through a brick within one tick
+void BreakoutLayer::moveBall(float dt) {
+    using namespace mamba::physics;
+
+    float remaining = 1.0f;
+    for (int impact = 0; impact < MAX_BALL_IMPACTS && remaining > 0.0f; ++impact) {
+        Circle ball{m_ball.position, m_ball.radius};
+        glm::vec2 displacement = m_ball.velocity * dt * remaining;
+
+        std::optional<ImpactInfo> first;
+        std::optional<uint32_t> first_brick;
+        // Overlaps at the start are left to checkCollisions, which also pushes the ball out
+        auto consider = [&](std::optional<ImpactInfo> hit) {
+            if (!hit || hit->time <= 0.0f || glm::dot(hit->normal, displacement) >= 0.0f)
+                return false;
+            if (first && first->time <= hit->time)
+                return false;
+            first = hit;
+            return true;
+        };
+
+        if (m_ball.velocity.y < 0.0f)
+            consider(sweep(ball, displacement, AABB{m_paddle.position, m_paddle.size}));
+
+        // Every brick the ball's path could reach
+        glm::vec2 end = m_ball.position + displacement;
+        AABB path{(m_ball.position + end) / 2.0f,
+                  glm::abs(displacement) + glm::vec2(m_ball.radius * 2.0f)};
+        m_brick_candidates.clear();
+        m_brick_grid.query(path, m_brick_candidates);
+        for (auto index : m_brick_candidates) {
+            const auto& brick = m_bricks[index];
+            if (consider(sweep(ball, displacement, AABB{brick.position, brick.size})))
+                first_brick = index;
+        }
+
+        if (!first) {
+            m_ball.position = end;
+            return;
+        }
+
+        m_ball.position += displacement * first->time + first->normal * CONTACT_GAP;
+        remaining *= 1.0f - first->time;
+        if (first_brick)
+            hitBrick(*first_brick, first->normal);
+        else
+            bounceOffPaddle();
+    }
+}
+
 void BreakoutLayer::checkCollisions() {
     using namespace mamba::physics;
 
@@ -172,50 +235,62 @@ void BreakoutLayer::checkCollisions() {
     if (auto hit = collides(ball, paddle_box)) {
         // Only bounce if ball is moving downward
         if (m_ball.velocity.y < 0.0f) {
-            m_ball.velocity.y = std::abs(m_ball.velocity.y);
-
-            // Add some angle based on where ball hit paddle
-            float hit_point = m_ball.position.x - m_paddle.position.x;
-            float normalized = hit_point / (m_paddle.size.x / 2.0f); // -1 to 1
-            m_ball.velocity.x = normalized * 300.0f;
+            bounceOffPaddle();
 
             // Push ball out of paddle
             m_ball.position -= hit->normal * hit->penetration;
         }
     }
 
-    // Ball vs Bricks collision
-    for (auto& brick : m_bricks) {
-        if (brick.destroyed) {
-            continue;
-        }
+    // Ball vs Bricks collision, only against bricks near the ball
+    m_brick_candidates.clear();
+    m_brick_grid.query(AABB{ball.center, glm::vec2(ball.radius * 2.0f)}, m_brick_candidates);
+    // Lowest index first, like walking the whole list
+    std::ranges::sort(m_brick_candidates);
 
+    for (auto index : m_brick_candidates) {
+        const auto& brick = m_bricks[index];
         AABB brick_box{brick.position, brick.size};
 
         if (auto hit = collides(ball, brick_box)) {
-            brick.hits--;
-            if (brick.hits <= 0) {
-                brick.destroyed = true;
-                m_score += 10;
-            }
-
-            // Determine collision side and bounce
-            if (std::abs(hit->normal.x) > std::abs(hit->normal.y)) {
-                // Horizontal collision
-                m_ball.velocity.x = -m_ball.velocity.x;
-            } else {
-                // Vertical collision
-                m_ball.velocity.y = -m_ball.velocity.y;
-            }
+            hitBrick(index, hit->normal);
 
             // Push ball out of brick
             m_ball.position -= hit->normal * hit->penetration;
 
-            break; // Only handle one brick collision per frame
+            break; // Only handle one brick collision per tick
         }
     }
 }
 
+void BreakoutLayer::hitBrick(uint32_t index, glm::vec2 normal) {
+    auto& brick = m_bricks[index];
+    brick.hits--;
+    if (brick.hits <= 0) {
+        brick.destroyed = true;
+        m_brick_grid.remove(index);
+        m_score += 10;
+    }
+
+    // Determine collision side and bounce
+    if (std::abs(normal.x) > std::abs(normal.y)) {
+        // Horizontal collision
+        m_ball.velocity.x = -m_ball.velocity.x;
+    } else {
+        // Vertical collision
+        m_ball.velocity.y = -m_ball.velocity.y;
+    }
+}
+
+void BreakoutLayer::bounceOffPaddle() {
+    m_ball.velocity.y = std::abs(m_ball.velocity.y);
+
+    // Add some angle based on where ball hit paddle
+    float hit_point = m_ball.position.x - m_paddle.position.x;
+    float normalized = hit_point / (m_paddle.size.x / 2.0f); // -1 to 1
+    m_ball.velocity.x = normalized * 300.0f;
+}
+
 void BreakoutLayer::onEvent(mamba::Event& event) {
     if (event.getEventType() == mamba::EventType::KeyPressed) {
         auto& key_event = static_cast<mamba::KeyPressedEvent&>(event);
@@ -237,7 +312,7 @@ void BreakoutLayer::onEvent(mamba::Event& event) {
     }
 }
 
-void BreakoutLayer::onRender() {
+void BreakoutLayer::onRender(float alpha) {
     auto& renderer = getApp()->getRenderer();
 
     // Clear background
@@ -257,27 +332,28 @@ void BreakoutLayer::onRender() {
         }
     }
 
+    glm::vec2 paddle_position = glm::mix(m_paddle_previous, m_paddle.position, alpha);
+    glm::vec2 ball_position = glm::mix(m_ball_previous, m_ball.position, alpha);
+
     // Draw paddle
-    renderer.drawQuad(m_paddle.position, m_paddle.size, PADDLE_COLOR);
+    renderer.drawQuad(paddle_position, m_paddle.size, PADDLE_COLOR);
 
     // Draw ball (as a small square for now)
     // renderer.drawQuad(m_ball.position, {m_ball.radius * 2.0f, m_ball.radius * 2.0f}, BALL_COLOR);
     glm::mat4 transform(1.0f);
-    transform = glm::translate(transform, glm::vec3(m_ball.position, 0.0f));
+    transform = glm::translate(transform, glm::vec3(ball_position, 0.0f));
     transform = glm::scale(transform, glm::vec3(m_ball.radius * 2.0f, m_ball.radius * 2.0f, 1.0f));
     renderer.drawCircle(transform, BALL_COLOR);
 
     // Draw UI text
     if (m_font) {
         // Score
-        std::string score_text = std::format("Score: {}", m_score);
-        renderer.drawText(score_text, *m_font, {10.0f, m_screen_height - 40.0f}, 32.0f,
-                          {1.0f, 1.0f, 1.0f, 1.0f});
+        renderer.drawTextFormat(*m_font, {10.0f, m_screen_height - 40.0f}, 32.0f,
+                                {1.0f, 1.0f, 1.0f, 1.0f}, "Score: {}", m_score);
 
         // Lives
-        std::string lives_text = std::format("Lives: {}", m_lives);
-        renderer.drawText(lives_text, *m_font, {m_screen_width - 120.0f, m_screen_height - 40.0f},
-                          32.0f, {1.0f, 1.0f, 1.0f, 1.0f});
+        renderer.drawTextFormat(*m_font, {m_screen_width - 120.0f, m_screen_height - 40.0f}, 32.0f,
+                                {1.0f, 1.0f, 1.0f, 1.0f}, "Lives: {}", m_lives);
 
         // Game state messages
         if (m_state == GameState::GameOver) {
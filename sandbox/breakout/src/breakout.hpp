@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -7,6 +8,7 @@
 #include <glm/ext.hpp>
 
 #include "layer.hpp"
+#include "physics/spatial_hash_grid.hpp"
 #include "renderer/camera.hpp"
 #include "renderer/font.hpp"
 
@@ -38,16 +40,20 @@ class BreakoutLayer : public mamba::Layer {
   public:
     BreakoutLayer();
 
-    void onUpdate(float dt) override;
+    void onUpdate(float) override;
+    void onFixedUpdate(float dt) override;
     void onEvent(mamba::Event& event) override;
-    void onRender() override;
+    void onRender(float alpha) override;
 
   private:
     void initGame();
     void resetBall();
     void updatePaddle(float dt);
     void updateBall(float dt);
+    void moveBall(float dt);
     void checkCollisions();
+    void hitBrick(uint32_t index, glm::vec2 normal);
+    void bounceOffPaddle();
 
     // Camera
     std::unique_ptr<mamba::OrthographicCamera> m_camera;
@@ -57,6 +63,14 @@ class BreakoutLayer : public mamba::Layer {
     Ball m_ball;
     std::vector<Brick> m_bricks;
 
+    // Live bricks by index, a brick's grid id is its index in m_bricks
+    mamba::physics::SpatialHashGrid m_brick_grid;
+    std::vector<mamba::physics::SpatialHashGrid::Id> m_brick_candidates;
+
+    // Positions before the last fixed update, rendering blends towards the current ones
+    glm::vec2 m_paddle_previous{0.0f};
+    glm::vec2 m_ball_previous{0.0f};
+
     // Game state
     GameState m_state{GameState::Playing};
     int m_score{0};
@@ -1,8 +1,12 @@
 #include "app.hpp"
 #include "breakout.hpp"
 
-int main() {
-    mamba::App app({.title = "Breakout", .width = 800, .height = 600});
+#include <string_view>
+
+int main(int argc, char** argv) {
+    bool benchmark = argc > 1 && std::string_view(argv[1]) == "--benchmark";
+
+    mamba::App app({.title = "Breakout", .width = 800, .height = 600, .benchmark = benchmark});
 
     app.pushLayer<BreakoutLayer>();
 
@@ -5,18 +5,22 @@
 #include "glm/ext/matrix_float4x4.hpp"
 #include "input.hpp"
 #include "physics/collision.hpp"
-#include "renderer/texture.hpp"
+#include "renderer/texture_loader.hpp"
 
 ButtonLayer::ButtonLayer() {
     using namespace ::mamba::Renderer;
-    // Load texture
-    m_texture = Texture::create("sandbox/example/assets/textures/Button.png");
     m_font = Font::create();
 
     m_ball = Ball({0.0f, 0.0f}, {0, 0}, 0.25, 1);
+    m_ball_previous = m_ball.position;
     m_ground = Ground{.center = {0.0f, -1.0f}, .size = {2.0f, 0.3f}};
 }
 
+void ButtonLayer::onAttach() {
+    // Decoded in the background, draws a placeholder until it is ready
+    m_texture = getApp()->getTextureLoader().load("sandbox/example/assets/textures/Button.png");
+}
+
 void ButtonLayer::onUpdate(float dt) {
     glm::vec2 framebuffer_size = getApp()->getWindow().getFrameBufferSize();
 
@@ -44,11 +48,12 @@ void ButtonLayer::onUpdate(float dt) {
     // Hover in pixel space (mouse is top-left origin -> convert to bottom-left)
     glm::vec2 mouse_pos = getApp()->getWindow().getMousePosition();
     mouse_pos.y = framebuffer_size.y - mouse_pos.y;
-    glm::vec2 min_bound = m_button_pos - half_size;
-    glm::vec2 max_bound = m_button_pos + half_size;
+    m_is_hovered = mamba::physics::contains(mamba::physics::AABB{m_button_pos, m_button_scale},
+                                            mouse_pos);
+}
 
-    m_is_hovered = mouse_pos.x >= min_bound.x && mouse_pos.x <= max_bound.x &&
-                   mouse_pos.y >= min_bound.y && mouse_pos.y <= max_bound.y;
+void ButtonLayer::onFixedUpdate(float dt) {
+    m_ball_previous = m_ball.position;
 
     m_ball.velocity.y += -9.8f * dt;
     m_ball.position.y += m_ball.velocity.y * dt;
@@ -90,7 +95,7 @@ void ButtonLayer::onEvent(mamba::Event& event) {
     }
 }
 
-void ButtonLayer::onRender() {
+void ButtonLayer::onRender(float alpha) {
     auto& renderer = getApp()->getRenderer();
 
     // World pass
@@ -104,7 +109,8 @@ void ButtonLayer::onRender() {
 
     {
         glm::mat4 circle_model(1.0f);
-        circle_model = glm::translate(circle_model, glm::vec3(m_ball.position, 1.0));
+        glm::vec2 ball_position = glm::mix(m_ball_previous, m_ball.position, alpha);
+        circle_model = glm::translate(circle_model, glm::vec3(ball_position, 1.0));
         circle_model = glm::scale(circle_model, glm::vec3(glm::vec2(m_ball.radius * 2.0f), 1.0f));
         renderer.drawCircle(circle_model, {1.0, 1.0, 1.0, 1.0});
     }
@@ -121,7 +127,7 @@ void ButtonLayer::onRender() {
     model = glm::translate(model, glm::vec3(m_button_pos, 0.0f));
     model = glm::scale(model, glm::vec3(m_button_scale, 1.0f));
     auto tint = m_is_hovered ? glm::vec4(glm::vec3(2.0), 1.0) : glm::vec4(glm::vec3(1.0), 1.0);
-    renderer.drawQuad(model, m_texture.value(), tint);
+    renderer.drawQuad(model, m_texture->get(), tint);
 
     renderer.end();
 }
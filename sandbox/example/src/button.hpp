@@ -6,7 +6,7 @@
 #include "layer.hpp"
 #include "renderer/camera_controller.hpp"
 #include "renderer/font.hpp"
-#include "renderer/texture.hpp"
+#include "renderer/texture_loader.hpp"
 
 struct Ball {
     glm::vec2 position;
@@ -24,14 +24,16 @@ class ButtonLayer : public mamba::Layer {
   public:
     ButtonLayer();
 
+    void onAttach() override;
     void onUpdate(float dt) override;
+    void onFixedUpdate(float dt) override;
     void onEvent(mamba::Event& event) override;
-    void onRender() override;
+    void onRender(float alpha) override;
 
   private:
     std::optional<mamba::CameraController> m_camera_controller;
     std::optional<mamba::OrthographicCamera> m_ui_camera;
-    std::optional<mamba::Renderer::Texture> m_texture;
+    std::optional<mamba::Renderer::TextureHandle> m_texture;
     std::optional<mamba::Renderer::Font> m_font;
 
     // UI button in pixel space
@@ -41,5 +43,6 @@ class ButtonLayer : public mamba::Layer {
     bool m_is_hovered{false};
 
     Ball m_ball;
+    glm::vec2 m_ball_previous{0.0f};
     Ground m_ground;
 };
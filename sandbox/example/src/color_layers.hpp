@@ -7,7 +7,7 @@
 
 class RedLayer : public mamba::Layer {
   public:
-    void onRender() override {
+    void onRender(float) override {
         auto& renderer = getApp()->getRenderer();
         renderer.setClearColor({1.0f, 0.0f, 0.0f, 1.0f});
         renderer.clear();
@@ -16,7 +16,7 @@ class RedLayer : public mamba::Layer {
 
 class GreenLayer : public mamba::Layer {
   public:
-    void onRender() override {
+    void onRender(float) override {
         auto& renderer = getApp()->getRenderer();
         renderer.setClearColor({0.0f, 1.0f, 0.0f, 1.0f});
         renderer.clear();
@@ -25,7 +25,7 @@ class GreenLayer : public mamba::Layer {
 
 class BlueLayer : public mamba::Layer {
   public:
-    void onRender() override {
+    void onRender(float) override {
         auto& renderer = getApp()->getRenderer();
         renderer.setClearColor({0.0f, 0.0f, 1.0f, 1.0f});
         renderer.clear();
@@ -1,8 +1,18 @@
 #include "app.hpp"
 #include "event.hpp"
 
+#include "renderer/image_writer.hpp"
+
+// clang-format off
+#include <glad/glad.h>
 #include <GLFW/glfw3.h>
+// clang-format on
+#include <algorithm>
+#include <format>
+#include <iostream>
 #include <ranges>
+#include <stdexcept>
+#include <vector>
 
 namespace mamba {
 
@@ -10,31 +20,113 @@ App::App(const AppSpecification& spec)
     : m_window(WindowSpecification{.title = spec.title,
                                    .width = spec.width,
                                    .height = spec.height,
-                                   .event_handler = [this](Event& e) { onEvent(e); }}) {}
+                                   .event_handler = [this](Event& e) { onEvent(e); },
+                                   .vsync = spec.benchmark ? VSyncMode::Off : spec.vsync,
+                                   .headless = spec.headless}),
+      m_fixed_timestep(1.0 / spec.fixed_update_rate),
+      m_max_fixed_updates(std::max(spec.max_fixed_updates, 1u)),
+      m_frame_limiter(spec.benchmark ? 0.0 : spec.target_fps),
+      m_frame_stats(spec.frame_stats_window), m_benchmark(spec.benchmark),
+      m_max_frames(spec.max_frames), m_capture_directory(spec.capture_directory),
+      m_capture_interval(std::max(spec.capture_interval, 1u)) {
+
+    if (spec.headless) {
+        m_framebuffer = Renderer::Framebuffer::create({spec.width, spec.height});
+        if (!m_framebuffer)
+            throw std::runtime_error("Failed to create the headless framebuffer");
+    }
+
+    if (!m_capture_directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(m_capture_directory, error);
+        if (error)
+            std::cerr << "Cannot create capture directory: " << m_capture_directory.string()
+                      << "\n";
+    }
+}
 
 void App::run() {
-    float last_time = static_cast<float>(glfwGetTime());
+    using Clock = std::chrono::steady_clock;
+
+    const float fixed_dt = static_cast<float>(m_fixed_timestep.count());
+    const auto max_backlog = m_fixed_timestep * m_max_fixed_updates;
+
+    auto last_time = Clock::now();
+    auto next_report = last_time + std::chrono::seconds(1);
+    std::chrono::duration<double> accumulator{0.0};
 
     while (!m_window.shouldClose() && m_running) {
-        float current_time = static_cast<float>(glfwGetTime());
-        float dt = current_time - last_time;
+        auto current_time = Clock::now();
+        std::chrono::duration<double> frame_time = current_time - last_time;
         last_time = current_time;
+        m_frame_stats.record(frame_time);
+
+        // Nobody watches a headless run in real time, keep the simulation reproducible instead
+        if (m_framebuffer)
+            frame_time = m_fixed_timestep;
+
+        if (m_benchmark && current_time >= next_report) {
+            next_report = current_time + std::chrono::seconds(1);
+            auto stats = m_frame_stats.summarize();
+            std::cout << std::format("frame time: mean {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms "
+                                     "({:.0f} fps)\n",
+                                     stats.mean_ms, stats.p99_ms, stats.max_ms,
+                                     1000.0 / stats.mean_ms);
+        }
 
         glfwPollEvents();
+        m_renderer.reloadShaders();
+        m_texture_loader.update();
 
         for (auto& layer : m_layers | std::views::reverse) {
-            layer->onUpdate(dt);
+            layer->onUpdate(static_cast<float>(frame_time.count()));
         }
 
+        accumulator = std::min(accumulator + frame_time, max_backlog);
+        while (accumulator >= m_fixed_timestep) {
+            for (auto& layer : m_layers | std::views::reverse) {
+                layer->onFixedUpdate(fixed_dt);
+            }
+            accumulator -= m_fixed_timestep;
+        }
+
+        if (m_framebuffer)
+            m_framebuffer->bind();
+
+        float alpha = static_cast<float>(accumulator / m_fixed_timestep);
         for (auto& layer : m_layers | std::views::reverse) {
-            layer->onRender();
+            layer->onRender(alpha);
         }
 
+        if (!m_capture_directory.empty() && m_frame_index % m_capture_interval == 0)
+            captureFrame(m_capture_directory / std::format("frame_{:05}.png", m_frame_index));
+
         m_layers.applyPendingTransitions();
         m_window.update();
+        m_frame_limiter.wait();
+
+        if (++m_frame_index == m_max_frames)
+            break;
     }
 }
 
+bool App::captureFrame(const std::filesystem::path& path) {
+    if (m_framebuffer) {
+        return Renderer::writePng(path, m_framebuffer->width(), m_framebuffer->height(),
+                                  m_framebuffer->readPixels(), true);
+    }
+
+    // Windowed, read the back buffer before it is presented
+    glm::uvec2 size(m_window.getFrameBufferSize());
+    std::vector<uint8_t> pixels(static_cast<size_t>(size.x) * size.y * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadnPixels(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), GL_RGBA,
+                  GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+    return Renderer::writePng(path, size.x, size.y, pixels, true);
+}
+
 void App::onEvent(Event& event) {
     if (event.getEventType() == EventType::WindowResize) {
         onWindowResize(static_cast<WindowResizeEvent&>(event));
@@ -1,11 +1,19 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
+#include "frame_pacing.hpp"
 #include "layer_stack.hpp"
+#include "renderer/framebuffer.hpp"
 #include "renderer/renderer.hpp"
+#include "renderer/texture_cache.hpp"
+#include "renderer/texture_loader.hpp"
 #include "window.hpp"
 #include "window_events.hpp"
 
@@ -15,6 +23,31 @@ struct AppSpecification {
     std::string title;
     uint32_t width;
     uint32_t height;
+    // Simulation ticks per second, independent of the frame rate
+    double fixed_update_rate = 60.0;
+    // After a stall, at most this many ticks run in one frame and the rest of the backlog is
+    // dropped, so a slow simulation cannot fall further behind every frame
+    uint32_t max_fixed_updates = 8;
+
+    VSyncMode vsync = VSyncMode::On;
+    // Caps the frame rate when above zero, on top of vsync. Saves power when the display
+    // refresh rate is far above what the application needs.
+    double target_fps = 0.0;
+    // Renders as fast as possible, ignoring vsync and target_fps, and prints frame time
+    // statistics once a second
+    bool benchmark = false;
+    // Frames the statistics from getFrameStats cover
+    size_t frame_stats_window = 240;
+
+    // Runs without a display and draws into an offscreen framebuffer of width x height, see
+    // WindowSpecification::headless. Simulation then advances by exactly one fixed timestep
+    // per frame, so runs are reproducible regardless of how fast the machine renders.
+    bool headless = false;
+    // Stops after this many frames, 0 runs until the window closes
+    uint64_t max_frames = 0;
+    // Saves every capture_interval-th frame as frame_NNNNN.png when not empty
+    std::filesystem::path capture_directory;
+    uint32_t capture_interval = 1;
 };
 
 class App {
@@ -23,6 +56,8 @@ class App {
     virtual ~App() = default;
 
     void run();
+    // Ends run() after the current frame
+    void close() { m_running = false; }
 
     template <std::derived_from<Layer> T, typename... Args> void pushLayer(Args&&... args) {
         auto layer = std::make_unique<T>(std::forward<Args>(args)...);
@@ -41,6 +76,13 @@ class App {
 
     Window& getWindow() { return m_window; }
     Renderer::Renderer2D& getRenderer() { return m_renderer; }
+    Renderer::TextureLoader& getTextureLoader() { return m_texture_loader; }
+    Renderer::TextureCache& getTextureCache() { return m_texture_cache; }
+    const FrameStats& getFrameStats() const { return m_frame_stats; }
+    uint64_t getFrameIndex() const { return m_frame_index; }
+
+    // Writes what has been drawn so far this frame as a PNG
+    bool captureFrame(const std::filesystem::path& path);
 
   private:
     void onEvent(Event& event);
@@ -48,7 +90,19 @@ class App {
 
     Window m_window;
     Renderer::Renderer2D m_renderer;
+    Renderer::TextureLoader m_texture_loader;
+    Renderer::TextureCache m_texture_cache;
     LayerStack m_layers;
+    std::chrono::duration<double> m_fixed_timestep;
+    uint32_t m_max_fixed_updates;
+    FrameLimiter m_frame_limiter;
+    FrameStats m_frame_stats;
+    bool m_benchmark;
+    std::optional<Renderer::Framebuffer> m_framebuffer;
+    uint64_t m_frame_index{0};
+    uint64_t m_max_frames;
+    std::filesystem::path m_capture_directory;
+    uint32_t m_capture_interval;
     bool m_running = true;
 };
 
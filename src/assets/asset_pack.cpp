@@ -0,0 +1,221 @@
+#include "asset_pack.hpp"
+
+#include "assets/lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace mamba::assets {
+
+// All fields little endian, which is every platform we ship on
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'M', 'A', 'M', 'B', 'A', 'P', 'K', '\0'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t BLOB_ALIGNMENT = 64;
+
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint64_t index_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+};
+static_assert(sizeof(Header) == 40);
+
+uint64_t hashName(std::string_view name) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct AssetPack::Entry {
+    uint64_t name_hash;
+    uint64_t offset;
+    uint64_t size; // Stored bytes
+    uint64_t original_size;
+    uint32_t name_offset; // Into the names block
+    uint32_t name_length;
+    AssetCompression compression;
+    uint32_t reserved;
+};
+
+void AssetPack::Builder::add(std::string name, std::span<const uint8_t> data, bool compress) {
+    if (compress) {
+        auto compressed = lz4::compress(data);
+        if (compressed.size() < data.size() - data.size() / 8) {
+            m_assets.push_back(
+                {std::move(name), std::move(compressed), data.size(), AssetCompression::LZ4});
+            return;
+        }
+    }
+    m_assets.push_back({std::move(name), {data.begin(), data.end()}, data.size(),
+                        AssetCompression::None});
+}
+
+bool AssetPack::Builder::write(const std::filesystem::path& path) const {
+    std::vector<const Asset*> order;
+    for (const auto& asset : m_assets) {
+        order.push_back(&asset);
+    }
+    std::ranges::sort(order, {}, [](const Asset* asset) { return hashName(asset->name); });
+
+    std::string names;
+    for (const auto* asset : order) {
+        names += asset->name;
+    }
+
+    size_t index_offset = sizeof(Header);
+    size_t names_offset = index_offset + order.size() * sizeof(Entry);
+    size_t offset = names_offset + names.size();
+
+    std::vector<Entry> entries;
+    uint32_t name_offset = 0;
+    for (const auto* asset : order) {
+        offset = alignUp(offset, BLOB_ALIGNMENT);
+        entries.push_back({
+            .name_hash = hashName(asset->name),
+            .offset = offset,
+            .size = asset->data.size(),
+            .original_size = asset->original_size,
+            .name_offset = name_offset,
+            .name_length = static_cast<uint32_t>(asset->name.size()),
+            .compression = asset->compression,
+            .reserved = 0,
+        });
+        name_offset += static_cast<uint32_t>(asset->name.size());
+        offset += asset->data.size();
+    }
+
+    Header header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .entry_count = static_cast<uint32_t>(entries.size()),
+        .index_offset = index_offset,
+        .names_offset = names_offset,
+        .names_size = names.size(),
+    };
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + index_offset, entries.data(), entries.size() * sizeof(Entry));
+    std::memcpy(file.data() + names_offset, names.data(), names.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        std::ranges::copy(order[i]->data, file.begin() + entries[i].offset);
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()),
+              static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        std::cerr << "Failed to write asset pack: " << path.string() << "\n";
+        return false;
+    }
+    return true;
+}
+
+std::optional<AssetPack> AssetPack::open(const std::filesystem::path& path) {
+    static_assert(sizeof(Entry) == 48, "Entry is read straight from the file");
+
+    auto file = MappedFile::open(path);
+    if (!file)
+        return std::nullopt;
+
+    auto data = file->data();
+    auto fail = [&](const char* reason) {
+        std::cerr << "Invalid asset pack " << path.string() << ": " << reason << "\n";
+        return std::nullopt;
+    };
+
+    Header header;
+    if (data.size() < sizeof(header))
+        return fail("truncated header");
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION)
+        return fail("unknown format");
+
+    size_t index_size = static_cast<size_t>(header.entry_count) * sizeof(Entry);
+    if (header.index_offset % alignof(Entry) != 0 || header.index_offset > data.size() ||
+        index_size > data.size() - header.index_offset || header.names_offset > data.size() ||
+        header.names_size > data.size() - header.names_offset)
+        return fail("index out of bounds");
+
+    // Validated once here, so lookups can trust the index
+    std::span entries(reinterpret_cast<const Entry*>(data.data() + header.index_offset),
+                      header.entry_count);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        if (i > 0 && entries[i - 1].name_hash > entry.name_hash)
+            return fail("index not sorted");
+        if (static_cast<uint64_t>(entry.name_offset) + entry.name_length > header.names_size)
+            return fail("name out of bounds");
+        if (entry.offset > data.size() || entry.size > data.size() - entry.offset)
+            return fail("asset out of bounds");
+        if (entry.compression != AssetCompression::None &&
+            entry.compression != AssetCompression::LZ4)
+            return fail("unknown compression");
+        // LZ4 cannot expand data by more than a factor of 255
+        if (entry.compression == AssetCompression::None ? entry.size != entry.original_size
+                                                        : entry.original_size / 255 > entry.size)
+            return fail("size mismatch");
+    }
+
+    AssetPack pack(std::move(*file));
+    pack.m_entries = entries.data();
+    pack.m_entry_count = entries.size();
+    pack.m_names = reinterpret_cast<const char*>(data.data() + header.names_offset);
+    return pack;
+}
+
+AssetPack::AssetPack(MappedFile&& file) : m_file(std::move(file)) {}
+
+auto AssetPack::find(std::string_view name) const -> const Entry* {
+    uint64_t hash = hashName(name);
+    const Entry* end = m_entries + m_entry_count;
+    const Entry* entry = std::lower_bound(
+        m_entries, end, hash, [](const Entry& e, uint64_t value) { return e.name_hash < value; });
+
+    for (; entry != end && entry->name_hash == hash; ++entry) {
+        if (std::string_view(m_names + entry->name_offset, entry->name_length) == name)
+            return entry;
+    }
+    return nullptr;
+}
+
+std::optional<AssetData> AssetPack::read(std::string_view name) const {
+    const Entry* entry = find(name);
+    if (!entry) {
+        std::cerr << "Asset not found: " << name << "\n";
+        return std::nullopt;
+    }
+
+    auto stored = m_file.data().subspan(entry->offset, entry->size);
+    if (entry->compression == AssetCompression::None)
+        return AssetData(stored);
+
+    std::vector<uint8_t> decompressed(entry->original_size);
+    if (!lz4::decompress(stored, decompressed)) {
+        std::cerr << "Corrupt asset: " << name << "\n";
+        return std::nullopt;
+    }
+    return AssetData(std::move(decompressed));
+}
+
+std::string_view AssetPack::getName(size_t index) const {
+    const Entry& entry = m_entries[index];
+    return {m_names + entry.name_offset, entry.name_length};
+}
+
+} // namespace mamba::assets
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "assets/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mamba::assets {
+
+/// Bytes of one asset. Stored assets view the pack mapping directly; compressed assets own
+/// their decompressed copy. Either way the view stays valid as long as both this object and
+/// the pack are alive.
+class AssetData {
+  public:
+    AssetData(const AssetData&) = delete;
+    AssetData& operator=(const AssetData&) = delete;
+    // Moving the storage vector keeps its buffer, so the view stays valid
+    AssetData(AssetData&&) noexcept = default;
+    AssetData& operator=(AssetData&&) noexcept = default;
+
+    std::span<const uint8_t> bytes() const { return m_view; }
+    std::string_view text() const {
+        return {reinterpret_cast<const char*>(m_view.data()), m_view.size()};
+    }
+
+  private:
+    friend class AssetPack;
+
+    explicit AssetData(std::span<const uint8_t> view) : m_view(view) {}
+    explicit AssetData(std::vector<uint8_t>&& storage)
+        : m_storage(std::move(storage)), m_view(m_storage) {}
+
+    std::vector<uint8_t> m_storage;
+    std::span<const uint8_t> m_view;
+};
+
+enum class AssetCompression : uint32_t { None = 0, LZ4 = 1 };
+
+/// Many assets in one memory-mapped file: a header, an index sorted by name hash, the names,
+/// and the asset blobs, each aligned to 64 bytes. Opening a pack maps it and validates the
+/// index, after which every lookup is a binary search and no file is ever opened again.
+///
+/// The loaders already take memory, so a pack plugs in without copies:
+///   Texture::createFromMemory(pack.read("textures/button.png")->bytes())
+///   Shader::createFromSource(vertex->text(), fragment->text())
+///   Font::create(pack.read("fonts/roboto.ttf")->bytes())
+class AssetPack {
+  public:
+    class Builder {
+      public:
+        // Compressed assets are only kept when LZ4 saves at least an eighth of their size
+        void add(std::string name, std::span<const uint8_t> data, bool compress = false);
+        bool write(const std::filesystem::path& path) const;
+
+      private:
+        struct Asset {
+            std::string name;
+            std::vector<uint8_t> data;
+            size_t original_size;
+            AssetCompression compression;
+        };
+
+        std::vector<Asset> m_assets;
+    };
+
+    static std::optional<AssetPack> open(const std::filesystem::path& path);
+
+    bool contains(std::string_view name) const { return find(name) != nullptr; }
+    // Null if the asset is missing or its compressed data is corrupt
+    std::optional<AssetData> read(std::string_view name) const;
+
+    size_t size() const { return m_entry_count; }
+    std::string_view getName(size_t index) const;
+
+  private:
+    struct Entry;
+
+    explicit AssetPack(MappedFile&& file);
+
+    const Entry* find(std::string_view name) const;
+
+    // Point into the mapping, which stays put when the pack is moved
+    MappedFile m_file;
+    const Entry* m_entries{nullptr};
+    size_t m_entry_count{0};
+    const char* m_names{nullptr};
+};
+
+} // namespace mamba::assets
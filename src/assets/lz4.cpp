@@ -0,0 +1,158 @@
+#include "lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace mamba::assets::lz4 {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+// The block format requires the last 5 bytes to be literals and the last match to start at
+// least 12 bytes before the end
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+
+uint32_t read32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void writeSequence(std::vector<uint8_t>& out, std::span<const uint8_t> literals, size_t offset,
+                   size_t match_length) {
+    size_t literal_length = literals.size();
+    size_t extra_match = match_length - MIN_MATCH;
+    auto token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4 |
+                                      std::min<size_t>(extra_match, 15));
+    out.push_back(token);
+    if (literal_length >= 15)
+        writeLength(out, literal_length - 15);
+    out.insert(out.end(), literals.begin(), literals.end());
+
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (extra_match >= 15)
+        writeLength(out, extra_match - 15);
+}
+
+} // namespace
+
+std::vector<uint8_t> compress(std::span<const uint8_t> source) {
+    std::vector<uint8_t> out;
+    out.reserve(compressBound(source.size()));
+
+    const uint8_t* data = source.data();
+    size_t size = source.size();
+    size_t anchor = 0;
+
+    if (size > MATCH_LIMIT) {
+        // Positions are stored off by one so zero means empty
+        std::array<uint32_t, 1 << HASH_BITS> table{};
+        size_t match_end_limit = size - LAST_LITERALS;
+
+        for (size_t i = 0; i + MATCH_LIMIT < size;) {
+            uint32_t sequence = read32(data + i);
+            uint32_t& slot = table[hash(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(i + 1);
+
+            if (candidate == 0 || i + 1 - candidate > MAX_OFFSET ||
+                read32(data + candidate - 1) != sequence) {
+                ++i;
+                continue;
+            }
+            --candidate;
+
+            size_t length = MIN_MATCH;
+            while (i + length < match_end_limit && data[candidate + length] == data[i + length]) {
+                ++length;
+            }
+
+            writeSequence(out, source.subspan(anchor, i - anchor), i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+    }
+
+    // Trailing literals form the last sequence, which has no match
+    size_t literal_length = size - anchor;
+    out.push_back(static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4));
+    if (literal_length >= 15)
+        writeLength(out, literal_length - 15);
+    out.insert(out.end(), data + anchor, data + size);
+    return out;
+}
+
+bool decompress(std::span<const uint8_t> source, std::span<uint8_t> destination) {
+    const uint8_t* in = source.data();
+    const uint8_t* in_end = in + source.size();
+    uint8_t* out = destination.data();
+    uint8_t* out_end = out + destination.size();
+
+    auto readLength = [&](size_t& length) {
+        uint8_t byte;
+        do {
+            if (in == in_end)
+                return false;
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < in_end) {
+        uint8_t token = *in++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !readLength(literal_length))
+            return false;
+        if (literal_length > static_cast<size_t>(in_end - in) ||
+            literal_length > static_cast<size_t>(out_end - out))
+            return false;
+        std::memcpy(out, in, literal_length);
+        in += literal_length;
+        out += literal_length;
+
+        // The last sequence ends after its literals
+        if (in == in_end)
+            break;
+
+        if (in_end - in < 2)
+            return false;
+        size_t offset = in[0] | in[1] << 8;
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - destination.data()))
+            return false;
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !readLength(match_length))
+            return false;
+        match_length += MIN_MATCH;
+        if (match_length > static_cast<size_t>(out_end - out))
+            return false;
+
+        // Byte by byte, matches may overlap the bytes they produce
+        const uint8_t* match = out - offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            out[i] = match[i];
+        }
+        out += match_length;
+    }
+
+    return out == out_end;
+}
+
+} // namespace mamba::assets::lz4
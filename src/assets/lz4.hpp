@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mamba::assets::lz4 {
+
+/// Upper bound of the compressed size of `size` input bytes
+constexpr size_t compressBound(size_t size) { return size + size / 255 + 16; }
+
+/// Compresses into the LZ4 block format (no frame header). A greedy single-probe matcher:
+/// much simpler than the reference encoder and a little larger output, decoded just as fast.
+std::vector<uint8_t> compress(std::span<const uint8_t> source);
+
+/// Decodes an LZ4 block into `destination`, which must be exactly the decompressed size.
+/// Returns false on malformed input instead of reading or writing out of bounds.
+bool decompress(std::span<const uint8_t> source, std::span<uint8_t> destination);
+
+} // namespace mamba::assets::lz4
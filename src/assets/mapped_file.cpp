@@ -0,0 +1,114 @@
+#include "mapped_file.hpp"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mamba::assets {
+
+#ifdef _WIN32
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open file: " << path.string() << "\n";
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return MappedFile(nullptr, 0, nullptr);
+    }
+
+    // The mapping keeps the file open, the file handle itself is not needed anymore
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        std::cerr << "Failed to map file: " << path.string() << "\n";
+        return std::nullopt;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        std::cerr << "Failed to map file: " << path.string() << "\n";
+        return std::nullopt;
+    }
+
+    return MappedFile(static_cast<const uint8_t*>(data), static_cast<size_t>(size.QuadPart),
+                      mapping);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+}
+
+#else
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << path.string() << "\n";
+        return std::nullopt;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return MappedFile(nullptr, 0, nullptr);
+    }
+
+    // The mapping keeps its own reference to the file
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << path.string() << "\n";
+        return std::nullopt;
+    }
+
+    return MappedFile(static_cast<const uint8_t*>(data), size, nullptr);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+      m_mapping(std::exchange(other.m_mapping, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_mapping, other.m_mapping);
+    return *this;
+}
+
+} // namespace mamba::assets
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace mamba::assets {
+
+/// Read-only memory mapping of a whole file. Pages are faulted in on first access, so opening
+/// costs one system call no matter how large the file is.
+class MappedFile {
+  public:
+    static std::optional<MappedFile> open(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) noexcept;
+    MappedFile& operator=(MappedFile&&) noexcept;
+
+    std::span<const uint8_t> data() const { return {m_data, m_size}; }
+
+  private:
+    MappedFile(const uint8_t* data, size_t size, void* mapping)
+        : m_data(data), m_size(size), m_mapping(mapping) {}
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    void* m_mapping{nullptr}; // File mapping object on Windows, unused elsewhere
+};
+
+} // namespace mamba::assets
@@ -0,0 +1,71 @@
+#include "frame_pacing.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+namespace mamba {
+
+FrameStats::FrameStats(size_t window) : m_window(std::max<size_t>(window, 1)) {
+    m_samples.reserve(m_window);
+    m_scratch.reserve(m_window);
+}
+
+void FrameStats::record(std::chrono::duration<double> frame_time) {
+    double ms = frame_time.count() * 1000.0;
+    if (m_samples.size() < m_window) {
+        m_samples.push_back(ms);
+        return;
+    }
+    m_samples[m_next] = ms;
+    m_next = (m_next + 1) % m_window;
+}
+
+FrameTimeSummary FrameStats::summarize() const {
+    if (m_samples.empty())
+        return {0, 0.0, 0.0, 0.0};
+
+    size_t count = m_samples.size();
+    double mean = std::accumulate(m_samples.begin(), m_samples.end(), 0.0) / count;
+    double max = *std::ranges::max_element(m_samples);
+
+    // Nearest rank, so small windows report a sample that actually happened
+    m_scratch.assign(m_samples.begin(), m_samples.end());
+    size_t rank = (count * 99 + 99) / 100 - 1;
+    std::ranges::nth_element(m_scratch, m_scratch.begin() + rank);
+
+    return {count, mean, m_scratch[rank], max};
+}
+
+void FrameStats::reset() {
+    m_samples.clear();
+    m_next = 0;
+}
+
+FrameLimiter::FrameLimiter(double target_fps) : m_deadline(Clock::now()) {
+    if (target_fps > 0.0)
+        m_period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / target_fps));
+}
+
+void FrameLimiter::wait() {
+    if (!enabled())
+        return;
+
+    // Wakeups overshoot by up to a scheduler tick, which is about 1 ms on Linux and macOS.
+    // Windows ticks at 15.6 ms unless the process raised its timer resolution.
+    constexpr auto SPIN_MARGIN = std::chrono::milliseconds(2);
+
+    auto now = Clock::now();
+    m_deadline += m_period;
+    // After a hitch, start over from now rather than rushing frames to catch up
+    if (m_deadline < now - m_period)
+        m_deadline = now;
+
+    if (m_deadline - now > SPIN_MARGIN)
+        std::this_thread::sleep_for(m_deadline - now - SPIN_MARGIN);
+    while (Clock::now() < m_deadline)
+        std::this_thread::yield();
+}
+
+} // namespace mamba
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace mamba {
+
+struct FrameTimeSummary {
+    size_t frames; // Samples the summary covers, at most the window size
+    double mean_ms;
+    double p99_ms;
+    double max_ms;
+};
+
+/// Frame times over a rolling window of the most recent frames
+class FrameStats {
+  public:
+    explicit FrameStats(size_t window = 240);
+
+    void record(std::chrono::duration<double> frame_time);
+    FrameTimeSummary summarize() const;
+    void reset();
+
+  private:
+    std::vector<double> m_samples; // Milliseconds, used as a ring buffer once full
+    size_t m_next{0};
+    size_t m_window;
+    mutable std::vector<double> m_scratch;
+};
+
+/// Holds frames to a fixed rate. The OS sleep is only trusted up to a margin before the
+/// deadline, the rest is spun out, so frames land on time without burning a core the whole
+/// frame.
+class FrameLimiter {
+  public:
+    // Zero or less disables the limiter
+    explicit FrameLimiter(double target_fps = 0.0);
+
+    bool enabled() const { return m_period.count() > 0; }
+
+    // Call once per frame, after presenting
+    void wait();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration m_period{0};
+    Clock::time_point m_deadline;
+};
+
+} // namespace mamba
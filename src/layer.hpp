@@ -12,16 +12,26 @@ class Layer {
   public:
     virtual ~Layer() = default;
 
+    // Called once the layer belongs to an App, getApp() is valid from here on
+    virtual void onAttach() {}
     virtual void onEvent(Event&) {}
+    // Once per frame with the variable frame time, for input, cameras and other non-simulation work
     virtual void onUpdate(float) {}
-    virtual void onRender() {}
+    // Zero or more times per frame with the fixed timestep, see AppSpecification::fixed_update_rate
+    virtual void onFixedUpdate(float) {}
+    // `alpha` is how far the frame lies between the last fixed update and the next one (0-1),
+    // for blending the previous and current simulation state
+    virtual void onRender(float) {}
 
     App* getApp() { return m_app; }
 
   private:
     App* m_app = nullptr;
 
-    void attach(App* app) { m_app = app; }
+    void attach(App* app) {
+        m_app = app;
+        onAttach();
+    }
 };
 
 } // namespace mamba
@@ -2,7 +2,9 @@
 
 #include <cmath>
 #include <glm/glm.hpp>
+#include <limits>
 #include <optional>
+#include <utility>
 
 namespace mamba::physics {
 
@@ -16,12 +18,45 @@ struct Circle {
     float radius;
 };
 
+/// AABB stored as its corners, cheaper to merge and compare when a box is tested many times
+struct Bounds {
+    glm::vec2 min;
+    glm::vec2 max;
+};
+
+/// Points origin + t * direction
+struct Ray {
+    glm::vec2 origin;
+    glm::vec2 direction;
+};
+
 /// Detailed collision information
 struct CollisionInfo {
     glm::vec2 normal;
     float penetration; // How far to push along normal
 };
 
+/// First contact of a ray or a moving shape
+struct ImpactInfo {
+    float time;       // Fraction of the ray's direction or the sweep's velocity, 0 to max
+    glm::vec2 normal; // Surface normal of the shape that was hit
+};
+
+/// Smallest AABB around a Circle
+inline AABB bounds(const Circle& circle) {
+    return {circle.center, glm::vec2(circle.radius * 2.0f)};
+}
+
+/// Convert an AABB to its corners and back
+inline Bounds toBounds(const AABB& box) {
+    glm::vec2 half = box.size / 2.0f;
+    return {box.center - half, box.center + half};
+}
+
+inline AABB toAABB(const Bounds& bounds) {
+    return {(bounds.min + bounds.max) / 2.0f, bounds.max - bounds.min};
+}
+
 /// Check if two AABBs overlap (fast boolean check)
 inline bool overlaps(const AABB& a, const AABB& b) {
     glm::vec2 half_a = a.size / 2.0f;
@@ -35,6 +70,11 @@ inline bool overlaps(const AABB& a, const AABB& b) {
     return x_overlap && y_overlap;
 }
 
+/// Check if two Bounds overlap (fast boolean check), like two AABBs
+inline bool overlaps(const Bounds& a, const Bounds& b) {
+    return a.min.x < b.max.x && a.max.x > b.min.x && a.min.y < b.max.y && a.max.y > b.min.y;
+}
+
 /// Check if two Circles overlap (fast boolean check)
 inline bool overlaps(const Circle& a, const Circle& b) {
     glm::vec2 diff = a.center - b.center;
@@ -126,4 +166,105 @@ inline bool contains(const Circle& circle, const glm::vec2& point) {
     return glm::dot(diff, diff) < circle.radius * circle.radius;
 }
 
+/// Slab test of a ray against an AABB, up to max_time along the ray
+/// Rays starting inside the box do not hit it
+inline std::optional<ImpactInfo> raycast(const Ray& ray, const AABB& box, float max_time = 1.0f) {
+    glm::vec2 half = box.size / 2.0f;
+    glm::vec2 min = box.center - half;
+    glm::vec2 max = box.center + half;
+
+    float enter = -std::numeric_limits<float>::infinity();
+    float exit = std::numeric_limits<float>::infinity();
+    glm::vec2 normal{0.0f};
+
+    for (int axis = 0; axis < 2; ++axis) {
+        // Parallel to this slab, either always inside it or never
+        if (std::abs(ray.direction[axis]) < std::numeric_limits<float>::epsilon()) {
+            if (ray.origin[axis] < min[axis] || ray.origin[axis] > max[axis])
+                return std::nullopt;
+            continue;
+        }
+
+        float inverse = 1.0f / ray.direction[axis];
+        float near = (min[axis] - ray.origin[axis]) * inverse;
+        float far = (max[axis] - ray.origin[axis]) * inverse;
+        if (near > far)
+            std::swap(near, far);
+
+        if (near > enter) {
+            enter = near;
+            normal = {0.0f, 0.0f};
+            normal[axis] = ray.direction[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+        exit = std::min(exit, far);
+    }
+
+    if (enter > exit || enter < 0.0f || enter > max_time)
+        return std::nullopt;
+    return ImpactInfo{enter, normal};
+}
+
+/// Ray against Circle, up to max_time along the ray
+/// Rays starting inside the circle do not hit it
+inline std::optional<ImpactInfo> raycast(const Ray& ray, const Circle& circle,
+                                         float max_time = 1.0f) {
+    // Solves |origin + t * direction - center| = radius for the smaller t
+    glm::vec2 offset = ray.origin - circle.center;
+    float a = glm::dot(ray.direction, ray.direction);
+    float b = glm::dot(offset, ray.direction);
+    float c = glm::dot(offset, offset) - circle.radius * circle.radius;
+
+    // Starting inside, or not moving at all
+    if (c < 0.0f || a == 0.0f)
+        return std::nullopt;
+    // Outside and moving away
+    if (b > 0.0f)
+        return std::nullopt;
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f)
+        return std::nullopt;
+
+    float time = (-b - std::sqrt(discriminant)) / a;
+    if (time > max_time)
+        return std::nullopt;
+
+    glm::vec2 normal = circle.radius > 0.0f ? (offset + ray.direction * time) / circle.radius
+                                            : -glm::normalize(ray.direction);
+    return ImpactInfo{time, normal};
+}
+
+/// Circle moving by velocity over a time of 1 against a static AABB, pass velocity * dt to
+/// sweep one step. Returns the time of first contact, the normal points from the box toward
+/// the circle. A circle already overlapping the box hits at time 0.
+inline std::optional<ImpactInfo> sweep(const Circle& circle, const glm::vec2& velocity,
+                                       const AABB& box) {
+    if (overlaps(circle, box)) {
+        auto hit = collides(circle, box);
+        return ImpactInfo{0.0f, -hit->normal};
+    }
+
+    // The circle's center against the box grown by the radius, whose corners are rounded
+    Ray path{circle.center, velocity};
+    glm::vec2 half = box.size / 2.0f;
+    glm::vec2 grown_half = half + glm::vec2(circle.radius);
+    glm::vec2 local = circle.center - box.center;
+
+    // Starting inside the grown box without overlapping is only possible next to a corner
+    if (std::abs(local.x) >= grown_half.x || std::abs(local.y) >= grown_half.y) {
+        auto hit = raycast(path, AABB{box.center, grown_half * 2.0f});
+        if (!hit)
+            return std::nullopt;
+
+        local += velocity * hit->time;
+        if (std::abs(local.x) <= half.x || std::abs(local.y) <= half.y)
+            return hit;
+    }
+
+    // Entered next to a corner, where the grown box is a quarter circle around it
+    glm::vec2 corner = box.center + glm::vec2(local.x > 0.0f ? half.x : -half.x,
+                                              local.y > 0.0f ? half.y : -half.y);
+    return raycast(path, Circle{corner, circle.radius});
+}
+
 } // namespace mamba::physics
@@ -0,0 +1,343 @@
+#pragma once
+
+// Batched forms of the tests in collision.hpp over structure-of-arrays collider sets. Each test
+// comes in two shapes: one filling a hit mask with a byte per collider and returning the number
+// of hits, one appending the indices of the hits. Results match the single-pair tests exactly.
+//
+// Kernels use AVX2 when the compiler targets it, SSE2 on any other x86-64 build and plain
+// scalar code elsewhere. Configure with MAMBA_AVX2 to build mamba and everything linking it
+// for AVX2.
+
+#include "physics/collision.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MAMBA_PHYSICS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAMBA_PHYSICS_SSE2 1
+#endif
+
+namespace mamba::physics {
+
+// The kernels this build uses, for reports
+#if defined(MAMBA_PHYSICS_AVX2)
+inline constexpr std::string_view BATCH_KERNELS = "avx2";
+#elif defined(MAMBA_PHYSICS_SSE2)
+inline constexpr std::string_view BATCH_KERNELS = "sse2";
+#else
+inline constexpr std::string_view BATCH_KERNELS = "scalar";
+#endif
+
+// Boxes keep center and half size, the same float operations as overlaps(AABB, AABB)
+struct BoxSet {
+    std::vector<float> x, y, half_x, half_y;
+
+    void push_back(const AABB& box) {
+        x.push_back(box.center.x);
+        y.push_back(box.center.y);
+        half_x.push_back(box.size.x / 2.0f);
+        half_y.push_back(box.size.y / 2.0f);
+    }
+    void reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        half_x.reserve(count);
+        half_y.reserve(count);
+    }
+    void clear() {
+        x.clear();
+        y.clear();
+        half_x.clear();
+        half_y.clear();
+    }
+    size_t size() const { return x.size(); }
+};
+
+struct CircleSet {
+    std::vector<float> x, y, radius;
+
+    void push_back(const Circle& circle) {
+        x.push_back(circle.center.x);
+        y.push_back(circle.center.y);
+        radius.push_back(circle.radius);
+    }
+    void reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        radius.reserve(count);
+    }
+    void clear() {
+        x.clear();
+        y.clear();
+        radius.clear();
+    }
+    size_t size() const { return x.size(); }
+};
+
+struct PointSet {
+    std::vector<float> x, y;
+
+    void push_back(const glm::vec2& point) {
+        x.push_back(point.x);
+        y.push_back(point.y);
+    }
+    void reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+    }
+    void clear() {
+        x.clear();
+        y.clear();
+    }
+    size_t size() const { return x.size(); }
+};
+
+namespace detail {
+
+// Every test is written once against these operations. They are overloaded for single floats,
+// used for the tail of each batch, and for a register of lanes.
+struct Narrow {};
+
+inline float load(Narrow, const float* values) { return *values; }
+inline float splat(Narrow, float value) { return value; }
+inline float add(float a, float b) { return a + b; }
+inline float sub(float a, float b) { return a - b; }
+inline float mul(float a, float b) { return a * b; }
+inline float negate(float a) { return -a; }
+// Argument order as in glm::min and glm::max, which differ from std:: on NaN only
+inline float min(float a, float b) { return b < a ? b : a; }
+inline float max(float a, float b) { return a < b ? b : a; }
+inline bool less(float a, float b) { return a < b; }
+inline bool lessEqual(float a, float b) { return a <= b; }
+inline bool both(bool a, bool b) { return a && b; }
+inline uint32_t bits(bool hit) { return hit ? 1u : 0u; }
+
+#if defined(MAMBA_PHYSICS_AVX2)
+struct Wide {};
+using Lanes = __m256;
+constexpr size_t LANE_COUNT = 8;
+
+inline Lanes load(Wide, const float* values) { return _mm256_loadu_ps(values); }
+inline Lanes splat(Wide, float value) { return _mm256_set1_ps(value); }
+inline Lanes add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+inline Lanes negate(Lanes a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+inline Lanes min(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+inline Lanes max(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+inline Lanes less(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline Lanes lessEqual(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline Lanes both(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+inline uint32_t bits(Lanes hits) { return static_cast<uint32_t>(_mm256_movemask_ps(hits)); }
+#elif defined(MAMBA_PHYSICS_SSE2)
+struct Wide {};
+using Lanes = __m128;
+constexpr size_t LANE_COUNT = 4;
+
+inline Lanes load(Wide, const float* values) { return _mm_loadu_ps(values); }
+inline Lanes splat(Wide, float value) { return _mm_set1_ps(value); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes negate(Lanes a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+inline Lanes min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+inline Lanes max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+inline Lanes less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+inline Lanes lessEqual(Lanes a, Lanes b) { return _mm_cmple_ps(a, b); }
+inline Lanes both(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+inline uint32_t bits(Lanes hits) { return static_cast<uint32_t>(_mm_movemask_ps(hits)); }
+#endif
+
+template <typename T>
+auto boxOverlapsBox(T ax, T ay, T ahx, T ahy, T bx, T by, T bhx, T bhy) {
+    return both(both(less(sub(ax, ahx), add(bx, bhx)), less(sub(bx, bhx), add(ax, ahx))),
+                both(less(sub(ay, ahy), add(by, bhy)), less(sub(by, bhy), add(ay, ahy))));
+}
+
+template <typename T>
+auto circleOverlapsCircle(T ax, T ay, T ar, T bx, T by, T br) {
+    T dx = sub(ax, bx);
+    T dy = sub(ay, by);
+    T radius = add(ar, br);
+    return less(add(mul(dx, dx), mul(dy, dy)), mul(radius, radius));
+}
+
+template <typename T>
+auto circleOverlapsBox(T cx, T cy, T radius, T bx, T by, T hx, T hy) {
+    T closest_x = add(bx, min(max(sub(cx, bx), negate(hx)), hx));
+    T closest_y = add(by, min(max(sub(cy, by), negate(hy)), hy));
+    T dx = sub(cx, closest_x);
+    T dy = sub(cy, closest_y);
+    return less(add(mul(dx, dx), mul(dy, dy)), mul(radius, radius));
+}
+
+template <typename T>
+auto boxContainsPoint(T bx, T by, T hx, T hy, T px, T py) {
+    return both(both(lessEqual(sub(bx, hx), px), lessEqual(px, add(bx, hx))),
+                both(lessEqual(sub(by, hy), py), lessEqual(py, add(by, hy))));
+}
+
+// Calls emit(first, bits, width) for every block of `width` colliders, bit k set when collider
+// first + k hit. `test(tag, i)` runs a test on the colliders starting at i, as many as the tag
+// covers.
+template <typename Test, typename Emit>
+void forEachBlock(size_t count, const Test& test, Emit&& emit) {
+    size_t i = 0;
+#if defined(MAMBA_PHYSICS_AVX2) || defined(MAMBA_PHYSICS_SSE2)
+    for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+        emit(i, bits(test(Wide{}, i)), LANE_COUNT);
+#endif
+    for (; i < count; ++i)
+        emit(i, bits(test(Narrow{}, i)), size_t{1});
+}
+
+// `mask` holds at least `count` entries
+template <typename Test>
+size_t writeMask(size_t count, const Test& test, std::span<uint8_t> mask) {
+    size_t hits = 0;
+    forEachBlock(count, test, [&](size_t first, uint32_t lanes, size_t width) {
+        hits += std::popcount(lanes);
+        for (size_t k = 0; k < width; ++k)
+            mask[first + k] = static_cast<uint8_t>(lanes >> k & 1);
+    });
+    return hits;
+}
+
+template <typename Test>
+void appendIndices(size_t count, const Test& test, std::vector<uint32_t>& hits) {
+    forEachBlock(count, test, [&](size_t first, uint32_t lanes, size_t) {
+        for (; lanes; lanes &= lanes - 1)
+            hits.push_back(static_cast<uint32_t>(first + std::countr_zero(lanes)));
+    });
+}
+
+inline auto circleVsBoxes(const Circle& circle, const BoxSet& boxes) {
+    return [&](auto tag, size_t i) {
+        return circleOverlapsBox(splat(tag, circle.center.x), splat(tag, circle.center.y),
+                                 splat(tag, circle.radius), load(tag, &boxes.x[i]),
+                                 load(tag, &boxes.y[i]), load(tag, &boxes.half_x[i]),
+                                 load(tag, &boxes.half_y[i]));
+    };
+}
+
+inline auto boxVsBoxes(const AABB& box, const BoxSet& boxes) {
+    return [&, half = box.size / 2.0f](auto tag, size_t i) {
+        return boxOverlapsBox(splat(tag, box.center.x), splat(tag, box.center.y),
+                              splat(tag, half.x), splat(tag, half.y), load(tag, &boxes.x[i]),
+                              load(tag, &boxes.y[i]), load(tag, &boxes.half_x[i]),
+                              load(tag, &boxes.half_y[i]));
+    };
+}
+
+inline auto boxVsPoints(const AABB& box, const PointSet& points) {
+    return [&, half = box.size / 2.0f](auto tag, size_t i) {
+        return boxContainsPoint(splat(tag, box.center.x), splat(tag, box.center.y),
+                                splat(tag, half.x), splat(tag, half.y), load(tag, &points.x[i]),
+                                load(tag, &points.y[i]));
+    };
+}
+
+inline auto circlesVsCircles(const CircleSet& a, const CircleSet& b) {
+    return [&](auto tag, size_t i) {
+        return circleOverlapsCircle(load(tag, &a.x[i]), load(tag, &a.y[i]),
+                                    load(tag, &a.radius[i]), load(tag, &b.x[i]),
+                                    load(tag, &b.y[i]), load(tag, &b.radius[i]));
+    };
+}
+
+inline auto boxesVsBoxes(const BoxSet& a, const BoxSet& b) {
+    return [&](auto tag, size_t i) {
+        return boxOverlapsBox(load(tag, &a.x[i]), load(tag, &a.y[i]), load(tag, &a.half_x[i]),
+                              load(tag, &a.half_y[i]), load(tag, &b.x[i]), load(tag, &b.y[i]),
+                              load(tag, &b.half_x[i]), load(tag, &b.half_y[i]));
+    };
+}
+
+inline auto circlesVsBoxes(const CircleSet& circles, const BoxSet& boxes) {
+    return [&](auto tag, size_t i) {
+        return circleOverlapsBox(load(tag, &circles.x[i]), load(tag, &circles.y[i]),
+                                 load(tag, &circles.radius[i]), load(tag, &boxes.x[i]),
+                                 load(tag, &boxes.y[i]), load(tag, &boxes.half_x[i]),
+                                 load(tag, &boxes.half_y[i]));
+    };
+}
+
+inline auto boxesVsPoints(const BoxSet& boxes, const PointSet& points) {
+    return [&](auto tag, size_t i) {
+        return boxContainsPoint(load(tag, &boxes.x[i]), load(tag, &boxes.y[i]),
+                                load(tag, &boxes.half_x[i]), load(tag, &boxes.half_y[i]),
+                                load(tag, &points.x[i]), load(tag, &points.y[i]));
+    };
+}
+
+} // namespace detail
+
+// One collider against every collider of a set
+
+inline size_t overlaps(const Circle& circle, const BoxSet& boxes, std::span<uint8_t> mask) {
+    return detail::writeMask(boxes.size(), detail::circleVsBoxes(circle, boxes), mask);
+}
+inline void overlaps(const Circle& circle, const BoxSet& boxes, std::vector<uint32_t>& hits) {
+    detail::appendIndices(boxes.size(), detail::circleVsBoxes(circle, boxes), hits);
+}
+
+inline size_t overlaps(const AABB& box, const BoxSet& boxes, std::span<uint8_t> mask) {
+    return detail::writeMask(boxes.size(), detail::boxVsBoxes(box, boxes), mask);
+}
+inline void overlaps(const AABB& box, const BoxSet& boxes, std::vector<uint32_t>& hits) {
+    detail::appendIndices(boxes.size(), detail::boxVsBoxes(box, boxes), hits);
+}
+
+inline size_t contains(const AABB& box, const PointSet& points, std::span<uint8_t> mask) {
+    return detail::writeMask(points.size(), detail::boxVsPoints(box, points), mask);
+}
+inline void contains(const AABB& box, const PointSet& points, std::vector<uint32_t>& hits) {
+    detail::appendIndices(points.size(), detail::boxVsPoints(box, points), hits);
+}
+
+// Element i of one set against element i of the other, over the shorter of the two
+
+inline size_t overlaps(const CircleSet& a, const CircleSet& b, std::span<uint8_t> mask) {
+    return detail::writeMask(std::min(a.size(), b.size()), detail::circlesVsCircles(a, b), mask);
+}
+inline void overlaps(const CircleSet& a, const CircleSet& b, std::vector<uint32_t>& hits) {
+    detail::appendIndices(std::min(a.size(), b.size()), detail::circlesVsCircles(a, b), hits);
+}
+
+inline size_t overlaps(const BoxSet& a, const BoxSet& b, std::span<uint8_t> mask) {
+    return detail::writeMask(std::min(a.size(), b.size()), detail::boxesVsBoxes(a, b), mask);
+}
+inline void overlaps(const BoxSet& a, const BoxSet& b, std::vector<uint32_t>& hits) {
+    detail::appendIndices(std::min(a.size(), b.size()), detail::boxesVsBoxes(a, b), hits);
+}
+
+inline size_t overlaps(const CircleSet& circles, const BoxSet& boxes, std::span<uint8_t> mask) {
+    return detail::writeMask(std::min(circles.size(), boxes.size()),
+                             detail::circlesVsBoxes(circles, boxes), mask);
+}
+inline void overlaps(const CircleSet& circles, const BoxSet& boxes, std::vector<uint32_t>& hits) {
+    detail::appendIndices(std::min(circles.size(), boxes.size()),
+                          detail::circlesVsBoxes(circles, boxes), hits);
+}
+
+inline size_t contains(const BoxSet& boxes, const PointSet& points, std::span<uint8_t> mask) {
+    return detail::writeMask(std::min(boxes.size(), points.size()),
+                             detail::boxesVsPoints(boxes, points), mask);
+}
+inline void contains(const BoxSet& boxes, const PointSet& points, std::vector<uint32_t>& hits) {
+    detail::appendIndices(std::min(boxes.size(), points.size()),
+                          detail::boxesVsPoints(boxes, points), hits);
+}
+
+} // namespace mamba::physics
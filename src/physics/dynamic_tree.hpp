@@ -0,0 +1,420 @@
+#pragma once
+
+#include "physics/collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mamba::physics {
+
+struct DynamicTreeSpecification {
+    // Leaves are stored this much larger on every side, so small moves do not reinsert them
+    float margin = 0.1f;
+    // Leaves are also stretched along the displacement passed to update, scaled by this
+    float displacement_multiplier = 4.0f;
+};
+
+/// Bounding volume hierarchy over fattened boxes, suited to colliders of very different sizes.
+/// Leaves are inserted next to the sibling that grows the tree's perimeter the least and
+/// ancestors are rotated on the way back up to keep the tree balanced.
+///
+/// Nodes live in one contiguous pool with a free list. Ids stay valid until removed but are
+/// not dense; attach an index of your own through user data.
+///
+/// Queries follow the same rules as SpatialHashGrid's, except that they test the fat boxes.
+class DynamicTree {
+  public:
+    using Id = uint32_t;
+    static constexpr Id NULL_ID = std::numeric_limits<Id>::max();
+
+    explicit DynamicTree(const DynamicTreeSpecification& spec = {})
+        : m_margin(spec.margin), m_displacement_multiplier(spec.displacement_multiplier) {}
+
+    Id insert(const AABB& bounds, uint32_t user_data = 0) {
+        Id leaf = allocateNode();
+        auto& node = m_nodes[leaf];
+        node.bounds = fatten(toBounds(bounds));
+        node.user_data = user_data;
+        node.height = 0;
+        insertLeaf(leaf);
+        ++m_size;
+        return leaf;
+    }
+    Id insert(const Circle& circle, uint32_t user_data = 0) {
+        return insert(bounds(circle), user_data);
+    }
+
+    // Returns true when the leaf had to be reinserted because it left its fat box
+    bool update(Id id, const AABB& bounds, glm::vec2 displacement = glm::vec2(0.0f)) {
+        Bounds tight = toBounds(bounds);
+        Bounds fat = fatten(tight);
+        glm::vec2 stretch = displacement * m_displacement_multiplier;
+        fat.min += glm::min(stretch, glm::vec2(0.0f));
+        fat.max += glm::max(stretch, glm::vec2(0.0f));
+
+        const Bounds& current = m_nodes[id].bounds;
+        if (contains(current, tight)) {
+            // Still inside, unless the fat box has grown far too large after a fast move
+            glm::vec2 slack(4.0f * m_margin);
+            if (contains({fat.min - slack, fat.max + slack}, current))
+                return false;
+        }
+
+        removeLeaf(id);
+        m_nodes[id].bounds = fat;
+        insertLeaf(id);
+        return true;
+    }
+    bool update(Id id, const Circle& circle, glm::vec2 displacement = glm::vec2(0.0f)) {
+        return update(id, bounds(circle), displacement);
+    }
+
+    void remove(Id id) {
+        removeLeaf(id);
+        freeNode(id);
+        --m_size;
+    }
+
+    void clear() {
+        m_nodes.clear();
+        m_free = NULL_ID;
+        m_root = NULL_ID;
+        m_size = 0;
+    }
+
+    AABB getFatBounds(Id id) const { return toAABB(m_nodes[id].bounds); }
+    uint32_t getUserData(Id id) const { return m_nodes[id].user_data; }
+    size_t size() const { return m_size; }
+    // Height of the root, 0 for a single leaf
+    int32_t getHeight() const { return m_root == NULL_ID ? 0 : m_nodes[m_root].height; }
+
+    // Calls callback(Id) for every leaf whose fat box overlaps `region`
+    template <typename F>
+    void query(const AABB& region, F&& callback) const {
+        Bounds bounds = toBounds(region);
+        traverse([&](const Bounds& node) { return overlaps(node, bounds); }, callback);
+    }
+
+    void query(const AABB& region, std::vector<Id>& out) const {
+        query(region, [&](Id id) { out.push_back(id); });
+    }
+
+    // Calls callback(Id) for every leaf whose fat box contains `point`, for picking
+    template <typename F>
+    void query(glm::vec2 point, F&& callback) const {
+        traverse(
+            [&](const Bounds& node) {
+                return point.x >= node.min.x && point.x <= node.max.x && point.y >= node.min.y &&
+                       point.y <= node.max.y;
+            },
+            callback);
+    }
+
+    // Casts the segment from `origin` to `origin + translation`. For every leaf the segment
+    // reaches, callback(Id, float max_fraction) returns the new max fraction along the
+    // segment: the leaf's hit fraction to clip the ray, max_fraction to ignore the leaf or 0 to
+    // stop. The hit fraction is the time of physics::raycast or physics::sweep against the
+    // leaf's shape with `translation` as the direction or velocity.
+    template <typename F>
+    void raycast(glm::vec2 origin, glm::vec2 translation, F&& callback) const {
+        cast(origin, translation, glm::vec2(0.0f), callback);
+    }
+
+    // Like raycast, for a box moved by `translation`
+    template <typename F>
+    void shapeCast(const AABB& shape, glm::vec2 translation, F&& callback) const {
+        cast(shape.center, translation, shape.size / 2.0f, callback);
+    }
+
+    // Like raycast, for a circle moved by `translation`. Leaves are tested against the circle's
+    // bounding box, so a few near misses at the corners are reported as well.
+    template <typename F>
+    void shapeCast(const Circle& shape, glm::vec2 translation, F&& callback) const {
+        cast(shape.center, translation, glm::vec2(shape.radius), callback);
+    }
+
+  private:
+    struct Node {
+        Bounds bounds;
+        Id parent{NULL_ID}; // Next free node while the node is on the free list
+        Id child1{NULL_ID};
+        Id child2{NULL_ID};
+        int32_t height{0}; // 0 for leaves, -1 for free nodes
+        uint32_t user_data{0};
+
+        bool isLeaf() const { return child1 == NULL_ID; }
+    };
+
+    static Bounds merge(const Bounds& a, const Bounds& b) {
+        return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    // The 2D counterpart of surface area in the insertion cost
+    static float perimeter(const Bounds& bounds) {
+        glm::vec2 size = bounds.max - bounds.min;
+        return 2.0f * (size.x + size.y);
+    }
+
+    static bool contains(const Bounds& outer, const Bounds& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+    }
+
+    // Slab test of origin + t * translation for t in [0, max_fraction]
+    static bool segmentOverlaps(const Bounds& bounds, glm::vec2 origin, glm::vec2 translation,
+                                float max_fraction) {
+        float t_min = 0.0f;
+        float t_max = max_fraction;
+        for (int axis = 0; axis < 2; ++axis) {
+            if (std::abs(translation[axis]) < std::numeric_limits<float>::epsilon()) {
+                if (origin[axis] < bounds.min[axis] || origin[axis] > bounds.max[axis])
+                    return false;
+                continue;
+            }
+            float inverse = 1.0f / translation[axis];
+            float t1 = (bounds.min[axis] - origin[axis]) * inverse;
+            float t2 = (bounds.max[axis] - origin[axis]) * inverse;
+            t_min = std::max(t_min, std::min(t1, t2));
+            t_max = std::min(t_max, std::max(t1, t2));
+            if (t_min > t_max)
+                return false;
+        }
+        return true;
+    }
+
+    Bounds fatten(const Bounds& bounds) const {
+        return {bounds.min - glm::vec2(m_margin), bounds.max + glm::vec2(m_margin)};
+    }
+
+    template <typename Test, typename F>
+    void traverse(Test&& test, F&& callback) const {
+        if (m_root == NULL_ID)
+            return;
+
+        m_stack.clear();
+        m_stack.push_back(m_root);
+        while (!m_stack.empty()) {
+            Id id = m_stack.back();
+            m_stack.pop_back();
+
+            const auto& node = m_nodes[id];
+            if (!test(node.bounds))
+                continue;
+            if (node.isLeaf()) {
+                callback(id);
+            } else {
+                m_stack.push_back(node.child1);
+                m_stack.push_back(node.child2);
+            }
+        }
+    }
+
+    // Nodes are grown by `extents` so the swept shape can be treated as a point
+    template <typename F>
+    void cast(glm::vec2 origin, glm::vec2 translation, glm::vec2 extents, F&& callback) const {
+        if (m_root == NULL_ID)
+            return;
+
+        float max_fraction = 1.0f;
+        m_stack.clear();
+        m_stack.push_back(m_root);
+        while (!m_stack.empty()) {
+            Id id = m_stack.back();
+            m_stack.pop_back();
+
+            const auto& node = m_nodes[id];
+            Bounds grown{node.bounds.min - extents, node.bounds.max + extents};
+            if (!segmentOverlaps(grown, origin, translation, max_fraction))
+                continue;
+
+            if (node.isLeaf()) {
+                max_fraction = callback(id, max_fraction);
+                if (max_fraction <= 0.0f)
+                    return;
+            } else {
+                m_stack.push_back(node.child1);
+                m_stack.push_back(node.child2);
+            }
+        }
+    }
+
+    Id allocateNode() {
+        if (m_free == NULL_ID) {
+            m_nodes.emplace_back();
+            return static_cast<Id>(m_nodes.size() - 1);
+        }
+        Id id = m_free;
+        m_free = m_nodes[id].parent;
+        m_nodes[id] = Node{};
+        return id;
+    }
+
+    void freeNode(Id id) {
+        m_nodes[id].parent = m_free;
+        m_nodes[id].height = -1;
+        m_free = id;
+    }
+
+    void insertLeaf(Id leaf) {
+        if (m_root == NULL_ID) {
+            m_root = leaf;
+            m_nodes[leaf].parent = NULL_ID;
+            return;
+        }
+
+        // Descend towards the cheapest sibling, stopping when pairing here is cheaper still
+        Bounds leaf_bounds = m_nodes[leaf].bounds;
+        Id index = m_root;
+        while (!m_nodes[index].isLeaf()) {
+            const auto& node = m_nodes[index];
+            float combined = perimeter(merge(node.bounds, leaf_bounds));
+
+            // Pairing with this node creates a parent covering both
+            float cost = 2.0f * combined;
+            // Descending grows every ancestor by at least this much
+            float inherited = 2.0f * (combined - perimeter(node.bounds));
+
+            auto descendCost = [&](Id child) {
+                const auto& child_node = m_nodes[child];
+                float grown = perimeter(merge(child_node.bounds, leaf_bounds));
+                if (!child_node.isLeaf())
+                    grown -= perimeter(child_node.bounds);
+                return grown + inherited;
+            };
+            float cost1 = descendCost(node.child1);
+            float cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        Id sibling = index;
+        Id old_parent = m_nodes[sibling].parent;
+        Id new_parent = allocateNode();
+        auto& parent = m_nodes[new_parent];
+        parent.parent = old_parent;
+        parent.bounds = merge(leaf_bounds, m_nodes[sibling].bounds);
+        parent.height = m_nodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        m_nodes[sibling].parent = new_parent;
+        m_nodes[leaf].parent = new_parent;
+
+        if (old_parent == NULL_ID)
+            m_root = new_parent;
+        else
+            replaceChild(old_parent, sibling, new_parent);
+
+        refit(new_parent);
+    }
+
+    void removeLeaf(Id leaf) {
+        if (leaf == m_root) {
+            m_root = NULL_ID;
+            return;
+        }
+
+        Id parent = m_nodes[leaf].parent;
+        Id grandparent = m_nodes[parent].parent;
+        Id sibling =
+            m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        m_nodes[sibling].parent = grandparent;
+        freeNode(parent);
+        if (grandparent == NULL_ID) {
+            m_root = sibling;
+            return;
+        }
+        replaceChild(grandparent, parent, sibling);
+        refit(grandparent);
+    }
+
+    void replaceChild(Id parent, Id old_child, Id new_child) {
+        auto& node = m_nodes[parent];
+        if (node.child1 == old_child)
+            node.child1 = new_child;
+        else
+            node.child2 = new_child;
+    }
+
+    // Rebalances and refits every ancestor from `index` up to the root
+    void refit(Id index) {
+        while (index != NULL_ID) {
+            index = balance(index);
+            auto& node = m_nodes[index];
+            const auto& child1 = m_nodes[node.child1];
+            const auto& child2 = m_nodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.bounds = merge(child1.bounds, child2.bounds);
+            index = node.parent;
+        }
+    }
+
+    // Rotates the taller grandchild up when one child is more than one level taller than the
+    // other. Returns the node now in `a`'s place.
+    Id balance(Id a) {
+        auto& node_a = m_nodes[a];
+        if (node_a.isLeaf() || node_a.height < 2)
+            return a;
+
+        Id b = node_a.child1;
+        Id c = node_a.child2;
+        int32_t difference = m_nodes[c].height - m_nodes[b].height;
+        if (difference > 1)
+            return rotateUp(a, c, b, false);
+        if (difference < -1)
+            return rotateUp(a, b, c, true);
+        return a;
+    }
+
+    // Moves `up` into `a`'s place with `a` as its first child. `a` keeps `other` and takes the
+    // shorter child of `up`, the taller one stays with `up`.
+    Id rotateUp(Id a, Id up, Id other, bool up_is_child1) {
+        auto& node_a = m_nodes[a];
+        auto& node_up = m_nodes[up];
+        Id f = node_up.child1;
+        Id g = node_up.child2;
+
+        node_up.child1 = a;
+        node_up.parent = node_a.parent;
+        node_a.parent = up;
+        if (node_up.parent == NULL_ID)
+            m_root = up;
+        else
+            replaceChild(node_up.parent, a, up);
+
+        Id taller = m_nodes[f].height > m_nodes[g].height ? f : g;
+        Id shorter = taller == f ? g : f;
+
+        node_up.child2 = taller;
+        if (up_is_child1)
+            node_a.child1 = shorter;
+        else
+            node_a.child2 = shorter;
+        m_nodes[shorter].parent = a;
+
+        node_a.bounds = merge(m_nodes[other].bounds, m_nodes[shorter].bounds);
+        node_a.height = 1 + std::max(m_nodes[other].height, m_nodes[shorter].height);
+        node_up.bounds = merge(node_a.bounds, m_nodes[taller].bounds);
+        node_up.height = 1 + std::max(node_a.height, m_nodes[taller].height);
+        return up;
+    }
+
+    float m_margin;
+    float m_displacement_multiplier;
+
+    std::vector<Node> m_nodes;
+    Id m_free{NULL_ID};
+    Id m_root{NULL_ID};
+    size_t m_size{0};
+
+    mutable std::vector<Id> m_stack;
+};
+
+} // namespace mamba::physics
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "physics/collision.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mamba::physics {
+
+struct SpatialHashGridSpecification {
+    // Around the size of a typical collider. Much smaller and colliders span many cells, much
+    // larger and every cell holds many colliders.
+    float cell_size = 64.0f;
+    // Rounded up to a power of two. Cells share buckets through the hash, so the world has no
+    // bounds; more buckets only means fewer unrelated colliders per bucket.
+    uint32_t bucket_count = 4096;
+};
+
+/// Uniform grid broadphase. Colliders are kept as bounding boxes; query and forEachPair report
+/// candidates whose boxes overlap, the exact shape test is left to the caller.
+///
+/// Buckets are stored as one flat array of ids with an offset per bucket, rebuilt on the next
+/// query after something was inserted or moved to different cells. Moves within the same
+/// cells and removals only touch the collider itself.
+///
+/// Queries are const but share scratch state, so one grid cannot be queried from several
+/// threads at once.
+class SpatialHashGrid {
+  public:
+    using Id = uint32_t;
+
+    explicit SpatialHashGrid(const SpatialHashGridSpecification& spec = {})
+        : m_inverse_cell_size(1.0f / spec.cell_size),
+          m_bucket_mask(std::bit_ceil(std::max(spec.bucket_count, 1u)) - 1) {}
+
+    // Ids of removed colliders are reused; after clear they start at 0 again, in insertion order
+    Id insert(const AABB& bounds) {
+        Id id;
+        if (m_free.empty()) {
+            id = static_cast<Id>(m_objects.size());
+            m_objects.emplace_back();
+        } else {
+            id = m_free.back();
+            m_free.pop_back();
+        }
+        m_objects[id] = {bounds, cellRange(bounds), true, false};
+        ++m_size;
+        m_dirty = true;
+        return id;
+    }
+    Id insert(const Circle& circle) { return insert(bounds(circle)); }
+
+    void update(Id id, const AABB& bounds) {
+        auto& object = m_objects[id];
+        object.bounds = bounds;
+        auto cells = cellRange(bounds);
+        if (cells != object.cells) {
+            object.cells = cells;
+            m_dirty = true;
+        }
+    }
+    void update(Id id, const Circle& circle) { update(id, bounds(circle)); }
+
+    // Stale bucket entries are skipped until the next rebuild
+    void remove(Id id) {
+        m_objects[id].alive = false;
+        m_free.push_back(id);
+        --m_size;
+    }
+
+    void clear() {
+        m_objects.clear();
+        m_free.clear();
+        m_size = 0;
+        m_dirty = true;
+    }
+
+    const AABB& getBounds(Id id) const { return m_objects[id].bounds; }
+    size_t size() const { return m_size; }
+
+    // Calls callback(Id) once for every collider whose box overlaps `region`
+    template <typename F>
+    void query(const AABB& region, F&& callback) const {
+        if (m_dirty)
+            rebuild();
+
+        if (++m_query_stamp == 0) {
+            std::ranges::fill(m_visited, 0);
+            m_query_stamp = 1;
+        }
+        m_visited.resize(m_objects.size(), 0);
+
+        auto visit = [&](Id id) {
+            if (m_visited[id] == m_query_stamp || !m_objects[id].alive)
+                return;
+            m_visited[id] = m_query_stamp;
+            if (overlaps(m_objects[id].bounds, region))
+                callback(id);
+        };
+
+        auto range = cellRange(region);
+        if (cellCount(range) > m_bucket_mask) {
+            // Covers more cells than there are buckets, every collider is a candidate anyway
+            for (Id id = 0; id < m_objects.size(); ++id)
+                visit(id);
+            return;
+        }
+
+        for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+            for (int32_t x = range.min_x; x <= range.max_x; ++x) {
+                uint32_t bucket = bucketOf(x, y);
+                for (uint32_t i = m_bucket_start[bucket]; i < m_bucket_start[bucket + 1]; ++i)
+                    visit(m_entries[i]);
+            }
+        }
+        for (Id id : m_oversized)
+            visit(id);
+    }
+
+    void query(const AABB& region, std::vector<Id>& out) const {
+        query(region, [&](Id id) { out.push_back(id); });
+    }
+
+    // Calls callback(Id, Id) once for every pair of colliders whose boxes overlap, lower id first
+    template <typename F>
+    void forEachPair(F&& callback) const {
+        if (m_dirty)
+            rebuild();
+
+        for (uint32_t bucket = 0; bucket <= m_bucket_mask; ++bucket) {
+            uint32_t begin = m_bucket_start[bucket];
+            uint32_t end = m_bucket_start[bucket + 1];
+            for (uint32_t i = begin; i < end; ++i) {
+                const auto& a = m_objects[m_entries[i]];
+                if (!a.alive)
+                    continue;
+                for (uint32_t j = i + 1; j < end; ++j) {
+                    const auto& b = m_objects[m_entries[j]];
+                    if (!b.alive || !overlaps(a.bounds, b.bounds))
+                        continue;
+                    // A pair shares every cell its overlap touches. Only the cell holding the
+                    // overlap's lower corner reports it, which is covered by both colliders.
+                    int32_t x = std::max(a.cells.min_x, b.cells.min_x);
+                    int32_t y = std::max(a.cells.min_y, b.cells.min_y);
+                    if (bucketOf(x, y) == bucket)
+                        callback(m_entries[i], m_entries[j]);
+                }
+            }
+        }
+
+        // Oversized colliders are in no bucket and are tested against everything
+        for (Id large : m_oversized) {
+            const auto& a = m_objects[large];
+            if (!a.alive)
+                continue;
+            for (Id id = 0; id < m_objects.size(); ++id) {
+                const auto& b = m_objects[id];
+                if (id == large || !b.alive || (b.oversized && id < large))
+                    continue;
+                if (overlaps(a.bounds, b.bounds))
+                    callback(std::min(large, id), std::max(large, id));
+            }
+        }
+    }
+
+  private:
+    // Colliders spanning more cells go to a separate list instead of filling many buckets
+    static constexpr uint32_t MAX_CELLS_PER_OBJECT = 64;
+
+    struct CellRange {
+        int32_t min_x, min_y, max_x, max_y;
+        bool operator==(const CellRange&) const = default;
+    };
+
+    struct Object {
+        AABB bounds;
+        CellRange cells;
+        bool alive;
+        bool oversized;
+    };
+
+    static uint32_t cellCount(const CellRange& range) {
+        auto width = static_cast<uint64_t>(range.max_x - range.min_x + 1);
+        auto height = static_cast<uint64_t>(range.max_y - range.min_y + 1);
+        return static_cast<uint32_t>(std::min<uint64_t>(width * height, UINT32_MAX));
+    }
+
+    CellRange cellRange(const AABB& bounds) const {
+        glm::vec2 half = bounds.size / 2.0f;
+        glm::vec2 min = (bounds.center - half) * m_inverse_cell_size;
+        glm::vec2 max = (bounds.center + half) * m_inverse_cell_size;
+        return {static_cast<int32_t>(std::floor(min.x)), static_cast<int32_t>(std::floor(min.y)),
+                static_cast<int32_t>(std::floor(max.x)), static_cast<int32_t>(std::floor(max.y))};
+    }
+
+    uint32_t bucketOf(int32_t x, int32_t y) const {
+        auto hash = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+        return hash & m_bucket_mask;
+    }
+
+    // Buckets an object's cells map to, each once even when several cells share a bucket
+    const std::vector<uint32_t>& bucketsOf(const CellRange& range) const {
+        m_scratch.clear();
+        for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+            for (int32_t x = range.min_x; x <= range.max_x; ++x)
+                m_scratch.push_back(bucketOf(x, y));
+        }
+        std::ranges::sort(m_scratch);
+        m_scratch.erase(std::ranges::unique(m_scratch).begin(), m_scratch.end());
+        return m_scratch;
+    }
+
+    // Counting sort of every live collider into its buckets
+    void rebuild() const {
+        uint32_t bucket_count = m_bucket_mask + 1;
+        m_bucket_start.assign(bucket_count + 1, 0);
+        m_oversized.clear();
+
+        for (Id id = 0; id < m_objects.size(); ++id) {
+            auto& object = m_objects[id];
+            if (!object.alive)
+                continue;
+            object.oversized = cellCount(object.cells) > MAX_CELLS_PER_OBJECT;
+            if (object.oversized) {
+                m_oversized.push_back(id);
+                continue;
+            }
+            for (uint32_t bucket : bucketsOf(object.cells))
+                ++m_bucket_start[bucket + 1];
+        }
+
+        for (uint32_t bucket = 0; bucket < bucket_count; ++bucket)
+            m_bucket_start[bucket + 1] += m_bucket_start[bucket];
+
+        m_entries.resize(m_bucket_start[bucket_count]);
+        m_cursor.assign(m_bucket_start.begin(), m_bucket_start.end() - 1);
+        for (Id id = 0; id < m_objects.size(); ++id) {
+            const auto& object = m_objects[id];
+            if (!object.alive || object.oversized)
+                continue;
+            for (uint32_t bucket : bucketsOf(object.cells))
+                m_entries[m_cursor[bucket]++] = id;
+        }
+
+        m_dirty = false;
+    }
+
+    float m_inverse_cell_size;
+    uint32_t m_bucket_mask;
+
+    // Rebuilt lazily, which only touches the oversized flag of each object
+    mutable std::vector<Object> m_objects;
+    std::vector<Id> m_free;
+    size_t m_size{0};
+
+    // Bucket b holds m_entries[m_bucket_start[b]] up to m_entries[m_bucket_start[b + 1]]
+    mutable std::vector<uint32_t> m_bucket_start;
+    mutable std::vector<Id> m_entries;
+    mutable std::vector<Id> m_oversized;
+    mutable bool m_dirty{true};
+
+    mutable std::vector<uint32_t> m_visited; // Query stamp per object, reports each id once
+    mutable uint32_t m_query_stamp{0};
+    mutable std::vector<uint32_t> m_scratch;
+    mutable std::vector<uint32_t> m_cursor;
+};
+
+} // namespace mamba::physics
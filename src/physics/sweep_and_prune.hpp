@@ -0,0 +1,224 @@
+#pragma once
+
+#include "physics/collision.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mamba::physics {
+
+/// Incremental sweep-and-prune broadphase. Box endpoints are kept sorted along both axes
+/// between frames; after colliders move, insertion sort restores the order in close to linear
+/// time and every swap of a lower with an upper endpoint marks a pair starting or stopping to
+/// overlap. Best when most colliders are static or move a little per frame.
+///
+/// Changes are applied by updatePairs, which reports the pairs added and removed since the
+/// previous call. Pairs are stored lower id first and compare boxes like overlaps(AABB, AABB),
+/// touching boxes do not overlap.
+class SweepAndPrune {
+  public:
+    using Id = uint32_t;
+
+    struct Pair {
+        Id a;
+        Id b;
+        bool operator==(const Pair&) const = default;
+    };
+
+    Id insert(const AABB& bounds) {
+        Id id;
+        if (m_free.empty()) {
+            id = static_cast<Id>(m_objects.size());
+            m_objects.emplace_back();
+        } else {
+            id = m_free.back();
+            m_free.pop_back();
+        }
+        m_objects[id] = toBounds(bounds);
+        for (auto& axis : m_axes) {
+            axis.push_back({0.0f, id << 1});
+            axis.push_back({0.0f, id << 1 | 1});
+        }
+        ++m_size;
+        ++m_pending_inserts;
+        return id;
+    }
+    Id insert(const Circle& circle) { return insert(bounds(circle)); }
+
+    void update(Id id, const AABB& bounds) { m_objects[id] = toBounds(bounds); }
+    void update(Id id, const Circle& circle) { update(id, bounds(circle)); }
+
+    // The id stays reserved until the next updatePairs, which reports its pairs as removed
+    void remove(Id id) {
+        // Moves both endpoints past every other one, ending all of the collider's overlaps
+        constexpr float far = std::numeric_limits<float>::max();
+        m_objects[id] = {glm::vec2(far), glm::vec2(far)};
+        m_pending_removals.push_back(id);
+        --m_size;
+    }
+
+    void clear() {
+        m_objects.clear();
+        m_free.clear();
+        for (auto& axis : m_axes)
+            axis.clear();
+        m_pairs.clear();
+        m_added.clear();
+        m_removed.clear();
+        m_pending_removals.clear();
+        m_pending_inserts = 0;
+        m_size = 0;
+    }
+
+    // Sorts the endpoints after inserts, moves and removals, and collects the pair changes
+    void updatePairs() {
+        m_added.clear();
+        m_removed.clear();
+
+        for (size_t axis = 0; axis < m_axes.size(); ++axis) {
+            for (auto& endpoint : m_axes[axis]) {
+                const auto& bounds = m_objects[endpoint.id()];
+                endpoint.value = endpoint.isMax() ? bounds.max[axis] : bounds.min[axis];
+            }
+        }
+
+        // Insertion sort degrades to quadratic when many new endpoints start out of place
+        if (m_pending_inserts * 4 > m_size) {
+            rebuild();
+        } else {
+            for (auto& axis : m_axes)
+                sortAxis(axis);
+        }
+        m_pending_inserts = 0;
+
+        if (!m_pending_removals.empty()) {
+            for (auto& axis : m_axes) {
+                std::erase_if(axis, [&](const Endpoint& endpoint) {
+                    return m_objects[endpoint.id()].min.x == std::numeric_limits<float>::max();
+                });
+            }
+            m_free.insert(m_free.end(), m_pending_removals.begin(), m_pending_removals.end());
+            m_pending_removals.clear();
+        }
+    }
+
+    const std::vector<Pair>& getAddedPairs() const { return m_added; }
+    const std::vector<Pair>& getRemovedPairs() const { return m_removed; }
+    size_t getPairCount() const { return m_pairs.size(); }
+    size_t size() const { return m_size; }
+
+    // Calls callback(Id, Id) for every overlapping pair as of the last updatePairs
+    template <typename F>
+    void forEachPair(F&& callback) const {
+        for (uint64_t pair : m_pairs)
+            callback(static_cast<Id>(pair >> 32), static_cast<Id>(pair));
+    }
+
+  private:
+    // Owner id in the upper bits, lowest bit set for upper endpoints
+    struct Endpoint {
+        float value;
+        uint32_t data;
+
+        Id id() const { return data >> 1; }
+        bool isMax() const { return data & 1; }
+    };
+
+    // Upper endpoints sort first on ties, so touching boxes never count as overlapping
+    static bool less(const Endpoint& a, const Endpoint& b) {
+        return a.value < b.value || (a.value == b.value && a.isMax() && !b.isMax());
+    }
+
+    static uint64_t key(Id a, Id b) {
+        if (a > b)
+            std::swap(a, b);
+        return static_cast<uint64_t>(a) << 32 | b;
+    }
+
+    bool overlaps(Id a, Id b) const { return physics::overlaps(m_objects[a], m_objects[b]); }
+
+    void addPair(Id a, Id b) {
+        if (m_pairs.insert(key(a, b)).second)
+            m_added.push_back({std::min(a, b), std::max(a, b)});
+    }
+
+    void removePair(Id a, Id b) {
+        if (m_pairs.erase(key(a, b)))
+            m_removed.push_back({std::min(a, b), std::max(a, b)});
+    }
+
+    // Every swap resolves one inversion, so each pair changes state on an axis at most once
+    void sortAxis(std::vector<Endpoint>& axis) {
+        for (size_t i = 1; i < axis.size(); ++i) {
+            Endpoint moving = axis[i];
+            size_t j = i;
+            for (; j > 0 && less(moving, axis[j - 1]); --j) {
+                const Endpoint& passed = axis[j - 1];
+                if (moving.id() != passed.id()) {
+                    // A lower endpoint moving below an upper one may start an overlap, the
+                    // other axis decides
+                    if (!moving.isMax() && passed.isMax()) {
+                        if (overlaps(moving.id(), passed.id()))
+                            addPair(moving.id(), passed.id());
+                    } else if (moving.isMax() && !passed.isMax()) {
+                        removePair(moving.id(), passed.id());
+                    }
+                }
+                axis[j] = passed;
+            }
+            axis[j] = moving;
+        }
+    }
+
+    // Full sort and one sweep along x, reporting the difference to the previous pairs
+    void rebuild() {
+        for (auto& axis : m_axes)
+            std::ranges::sort(axis, less);
+
+        std::unordered_set<uint64_t> pairs;
+        m_active.clear();
+        for (const auto& endpoint : m_axes[0]) {
+            Id id = endpoint.id();
+            if (endpoint.isMax()) {
+                std::erase(m_active, id);
+                continue;
+            }
+            for (Id other : m_active) {
+                if (overlaps(id, other))
+                    pairs.insert(key(id, other));
+            }
+            m_active.push_back(id);
+        }
+
+        for (uint64_t pair : pairs) {
+            if (!m_pairs.contains(pair))
+                m_added.push_back({static_cast<Id>(pair >> 32), static_cast<Id>(pair)});
+        }
+        for (uint64_t pair : m_pairs) {
+            if (!pairs.contains(pair))
+                m_removed.push_back({static_cast<Id>(pair >> 32), static_cast<Id>(pair)});
+        }
+        m_pairs = std::move(pairs);
+    }
+
+    std::vector<Bounds> m_objects;
+    std::vector<Id> m_free;
+    std::vector<Id> m_pending_removals;
+    size_t m_pending_inserts{0};
+    size_t m_size{0};
+
+    std::array<std::vector<Endpoint>, 2> m_axes;
+    std::unordered_set<uint64_t> m_pairs;
+    std::vector<Pair> m_added;
+    std::vector<Pair> m_removed;
+    std::vector<Id> m_active;
+};
+
+} // namespace mamba::physics
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <span>
 #include <stdexcept>
+#include <utility>
 
 #include <msdf-atlas-gen/FontGeometry.h>
 #include <msdf-atlas-gen/msdf-atlas-gen.h>
@@ -13,28 +14,111 @@
 
 namespace mamba::Renderer {
 
-Font Font::create() {
+namespace {
 
-    auto ft = msdfgen::initializeFreetype();
-    if (!ft)
-        throw std::runtime_error("Cannot load freetype");
-    auto font = msdfgen::loadFontData(ft, Fonts::ROBOTO.data(), Fonts::ROBOTO.size());
-    if (!font)
+// The ImmediateAtlasGenerator class facilitates the generation of the atlas bitmap.
+template <int Channels, msdf_atlas::GeneratorFunction<float, Channels> Generator>
+Texture generateAtlas(std::span<msdf_atlas::GlyphGeometry> glyphs, int width, int height,
+                      int thread_count) {
+    msdf_atlas::ImmediateAtlasGenerator<
+        float,     // pixel type of buffer for individual glyphs depends on generator function
+        Channels,  // number of atlas color channels
+        Generator, // function to generate bitmaps for individual glyphs
+        msdf_atlas::BitmapAtlasStorage<uint8_t, Channels> // class that stores the atlas bitmap
+        >
+        generator(width, height);
+
+    // GeneratorAttributes can be modified to change the generator's default settings.
+    msdf_atlas::GeneratorAttributes attributes;
+    generator.setAttributes(attributes);
+    generator.setThreadCount(thread_count);
+    // Generate atlas bitmap
+    generator.generate(glyphs.data(), glyphs.size());
+
+    const auto& bitmap =
+        static_cast<msdfgen::BitmapConstRef<uint8_t, Channels>>(generator.atlasStorage());
+    // Distance fields are sampled at roughly their native size, mips would only blur the edges
+    return Texture::create(bitmap.pixels, bitmap.width, bitmap.height, Channels,
+                           {.generate_mips = false, .wrap = TextureWrap::ClampToEdge});
+}
+
+// Releases the FreeType library and face on every exit path
+struct FreetypeFont {
+    msdfgen::FreetypeHandle* ft = msdfgen::initializeFreetype();
+    msdfgen::FontHandle* font = nullptr;
+
+    FreetypeFont() {
+        if (!ft)
+            throw std::runtime_error("Cannot load freetype");
+    }
+    ~FreetypeFont() {
+        if (font)
+            msdfgen::destroyFont(font);
+        msdfgen::deinitializeFreetype(ft);
+    }
+    FreetypeFont(const FreetypeFont&) = delete;
+    FreetypeFont& operator=(const FreetypeFont&) = delete;
+};
+
+} // namespace
+
+Font::Font(Texture&& texture, msdf_atlas::FontGeometry&& geometry, float pixel_range,
+           FontAtlasFormat format)
+    : m_texture(std::move(texture)), m_font_geometry(std::move(geometry)),
+      m_pixel_range(pixel_range), m_format(format),
+      m_line_height(static_cast<float>(m_font_geometry.getMetrics().lineHeight)) {
+
+    m_ascii_glyphs.fill(-1);
+
+    auto width = static_cast<double>(m_texture.width());
+    auto height = static_cast<double>(m_texture.height());
+
+    for (const auto& glyph : m_font_geometry.getGlyphs()) {
+        double al, ab, ar, at; // atlas left, bottom, right, top
+        glyph.getQuadAtlasBounds(al, ab, ar, at);
+
+        double pl, pb, pr, pt; // plane left, bottom, right, top
+        glyph.getQuadPlaneBounds(pl, pb, pr, pt);
+
+        auto index = static_cast<uint32_t>(m_glyphs.size());
+        m_glyphs.push_back({
+            .plane = glm::vec4{pl, pb, pr, pt},
+            .uv = glm::vec4{al / width, ab / height, ar / width, at / height},
+            .advance = static_cast<float>(glyph.getAdvance()),
+        });
+
+        uint32_t codepoint = glyph.getCodepoint();
+        if (codepoint < m_ascii_glyphs.size())
+            m_ascii_glyphs[codepoint] = static_cast<int32_t>(index);
+        else
+            m_glyph_index.emplace(codepoint, index);
+    }
+}
+
+Font Font::create(const FontSpecification& spec) { return create(Fonts::ROBOTO, spec); }
+
+Font Font::create(const std::filesystem::path& path, const FontSpecification& spec) {
+    FreetypeFont handle;
+    std::string filepath = path.string();
+    handle.font = msdfgen::loadFont(handle.ft, filepath.c_str());
+    if (!handle.font)
+        throw std::runtime_error("Cannot load font: " + filepath);
+    return load(handle.font, spec);
+}
+
+Font Font::create(std::span<const uint8_t> data, const FontSpecification& spec) {
+    FreetypeFont handle;
+    handle.font = msdfgen::loadFontData(handle.ft, data.data(), static_cast<int>(data.size()));
+    if (!handle.font)
         throw std::runtime_error("Cannot load font");
+    return load(handle.font, spec);
+}
 
-    // --- Charset (ASCII) ---
-    msdf_atlas::Charset charset;
-    for (uint32_t c = 32; c < 128; ++c)
-        charset.add(c);
+Font Font::load(msdfgen::FontHandle* font, const FontSpecification& spec) {
 
     // --- Font geometry ---
-    // constexpr double em_size = 40.0;
-    // constexpr double pixel_range = 4.0;
-    // constexpr double miter = 2.0;
-    // constexpr int padding = 2;
-
     msdf_atlas::FontGeometry font_geometry;
-    font_geometry.loadCharset(font, 1.0, msdf_atlas::Charset::ASCII);
+    font_geometry.loadCharset(font, 1.0, spec.charset);
 
     // Get mutable access to glyphs for edge coloring
     auto glyph_range = font_geometry.getGlyphs();
@@ -42,47 +126,48 @@ Font Font::create() {
     std::span<msdf_atlas::GlyphGeometry> glyphs{temp, glyph_range.size()};
 
     // Apply MSDF edge coloring. See edge-coloring.h for other coloring strategies.
-    const double maxCornerAngle = 3.0;
-    for (auto& glyph : glyphs)
-        glyph.edgeColoring(&msdfgen::edgeColoringInkTrap, maxCornerAngle, 0);
+    // Single channel distance fields do not use edge colors.
+    if (spec.format != FontAtlasFormat::SDF) {
+        const double maxCornerAngle = 3.0;
+        for (auto& glyph : glyphs)
+            glyph.edgeColoring(&msdfgen::edgeColoringInkTrap, maxCornerAngle, 0);
+    }
 
     // TightAtlasPacker class computes the layout of the atlas.
     msdf_atlas::TightAtlasPacker packer;
     // setScale for a fixed size or setMinimumScale to use the largest that fits
-    packer.setMinimumScale(24.0);
+    packer.setMinimumScale(spec.em_size);
     // setPixelRange or setUnitRange
-    packer.setPixelRange(2.0);
-    packer.setMiterLimit(1.0);
+    packer.setPixelRange(spec.pixel_range);
+    packer.setMiterLimit(spec.miter_limit);
     // Compute atlas layout - pack glyphs
-    packer.pack(glyphs.data(), glyphs.size());
+    if (packer.pack(glyphs.data(), glyphs.size()) != 0)
+        throw std::runtime_error("Cannot pack font atlas");
 
     // Get final atlas dimensions
     int width = 0, height = 0;
     packer.getDimensions(width, height);
 
-    // The ImmediateAtlasGenerator class facilitates the generation of the atlas bitmap.
-    msdf_atlas::ImmediateAtlasGenerator<
-        float, // pixel type of buffer for individual glyphs depends on generator function
-        4,     // number of atlas color channels
-        msdf_atlas::mtsdfGenerator, // function to generate bitmaps for individual glyphs
-        msdf_atlas::BitmapAtlasStorage<uint8_t, 4> // class that stores the atlas bitmap
-        >
-        generator(width, height);
-
-    // GeneratorAttributes can be modified to change the generator's default settings.
-    msdf_atlas::GeneratorAttributes attributes;
-    generator.setAttributes(attributes);
-    generator.setThreadCount(4);
-    // Generate atlas bitmap
-    generator.generate(glyphs.data(), glyphs.size());
-
-    const auto& bitmap = static_cast<msdfgen::BitmapConstRef<uint8_t, 4>>(generator.atlasStorage());
-
-    msdfgen::destroyFont(font);
-    msdfgen::deinitializeFreetype(ft);
-
-    return Font(Texture::create(bitmap.pixels, bitmap.width, bitmap.height, 4),
-                std::move(font_geometry));
+    auto pixel_range = static_cast<float>(spec.pixel_range);
+    switch (spec.format) {
+    case FontAtlasFormat::SDF: {
+        Texture texture =
+            generateAtlas<1, msdf_atlas::sdfGenerator>(glyphs, width, height, spec.thread_count);
+        // Broadcast the distance so the text shader's median and alpha both read it
+        constexpr GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_RED};
+        glTextureParameteriv(texture.handle(), GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        return Font(std::move(texture), std::move(font_geometry), pixel_range, spec.format);
+    }
+    case FontAtlasFormat::MSDF:
+        return Font(
+            generateAtlas<3, msdf_atlas::msdfGenerator>(glyphs, width, height, spec.thread_count),
+            std::move(font_geometry), pixel_range, spec.format);
+    case FontAtlasFormat::MTSDF:
+        return Font(
+            generateAtlas<4, msdf_atlas::mtsdfGenerator>(glyphs, width, height, spec.thread_count),
+            std::move(font_geometry), pixel_range, spec.format);
+    }
+    std::unreachable();
 }
 
 } // namespace mamba::Renderer
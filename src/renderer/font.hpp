@@ -1,18 +1,124 @@
 #pragma once
 #include "msdf-atlas-gen/FontGeometry.h"
 #include "renderer/texture.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace msdfgen {
+class FontHandle;
+}
+
 namespace mamba::Renderer {
 
+enum class FontAtlasFormat {
+    SDF,   // Single channel, true distance. Rounds sharp corners
+    MSDF,  // Three channels, sharp corners
+    MTSDF, // MSDF plus true distance in alpha, needed by text glow and shadow
+};
+
+struct FontSpecification {
+    msdf_atlas::Charset charset = msdf_atlas::Charset::ASCII;
+    double em_size = 24.0; // Minimum atlas pixels per em
+    double pixel_range = 2.0;
+    double miter_limit = 1.0;
+    int thread_count = 4;
+    FontAtlasFormat format = FontAtlasFormat::MTSDF;
+};
+
+/// Decodes the UTF-8 code point starting at `index` and advances `index` past it.
+/// Malformed sequences decode to U+FFFD and skip a single byte.
+inline uint32_t nextCodepoint(std::string_view text, size_t& index) {
+    constexpr uint32_t replacement = 0xFFFD;
+    auto byte = [&](size_t i) { return static_cast<uint8_t>(text[i]); };
+
+    uint8_t lead = byte(index);
+    size_t length = 0;
+    if (lead < 0x80)
+        length = 1;
+    else if ((lead & 0xE0) == 0xC0)
+        length = 2;
+    else if ((lead & 0xF0) == 0xE0)
+        length = 3;
+    else if ((lead & 0xF8) == 0xF0)
+        length = 4;
+
+    if (length == 1) {
+        ++index;
+        return lead;
+    }
+    if (length == 0 || index + length > text.size()) {
+        ++index;
+        return replacement;
+    }
+
+    uint32_t codepoint = lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        uint8_t continuation = byte(index + i);
+        if ((continuation & 0xC0) != 0x80) {
+            ++index;
+            return replacement;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+    }
+    index += length;
+    return codepoint;
+}
+
 class Font {
   public:
-    static Font create();
+    /// Glyph metrics flattened for the text hot path
+    struct Glyph {
+        glm::vec4 plane; // left, bottom, right, top in em units relative to the pen
+        glm::vec4 uv;    // left, bottom, right, top normalized atlas coordinates
+        float advance;
+    };
+
+    // Embedded Roboto
+    static Font create(const FontSpecification& spec = {});
+    // TTF/OTF file on disk
+    static Font create(const std::filesystem::path& path, const FontSpecification& spec = {});
+    // TTF/OTF file in memory, only needs to outlive the call
+    static Font create(std::span<const uint8_t> data, const FontSpecification& spec = {});
+
     const Texture& getAtlasTexture() const { return m_texture; }
     const msdf_atlas::FontGeometry& getFontGeometry() const { return m_font_geometry; }
+    // Distance field range of the atlas, in atlas pixels
+    float getPixelRange() const { return m_pixel_range; }
+    FontAtlasFormat getAtlasFormat() const { return m_format; }
+    float getLineHeight() const { return m_line_height; }
+
+    const Glyph* getGlyph(uint32_t codepoint) const {
+        if (codepoint < m_ascii_glyphs.size()) {
+            int32_t index = m_ascii_glyphs[codepoint];
+            return index < 0 ? nullptr : &m_glyphs[index];
+        }
+        auto iter = m_glyph_index.find(codepoint);
+        return iter == m_glyph_index.end() ? nullptr : &m_glyphs[iter->second];
+    }
 
   private:
-    Font(Texture&& texture, msdf_atlas::FontGeometry&& geometry)
-        : m_texture(std::move(texture)), m_font_geometry(std::move(geometry)) {}
+    Font(Texture&& texture, msdf_atlas::FontGeometry&& geometry, float pixel_range,
+         FontAtlasFormat format);
+
+    static Font load(msdfgen::FontHandle* font, const FontSpecification& spec);
+
     Texture m_texture;
     msdf_atlas::FontGeometry m_font_geometry;
+    float m_pixel_range;
+    FontAtlasFormat m_format;
+    float m_line_height;
+
+    // ASCII resolves through a direct table, everything else through the hash map
+    std::vector<Glyph> m_glyphs;
+    std::array<int32_t, 128> m_ascii_glyphs;
+    std::unordered_map<uint32_t, uint32_t> m_glyph_index;
 };
 } // namespace mamba::Renderer
@@ -0,0 +1,97 @@
+#include "framebuffer.hpp"
+
+#include <iostream>
+#include <utility>
+
+namespace mamba::Renderer {
+
+std::optional<Framebuffer> Framebuffer::create(const FramebufferSpecification& spec) {
+    Framebuffer framebuffer;
+    framebuffer.m_width = spec.width;
+    framebuffer.m_height = spec.height;
+    if (!framebuffer.createAttachments())
+        return std::nullopt;
+    return framebuffer;
+}
+
+Framebuffer::~Framebuffer() { release(); }
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, 0)), m_color(std::exchange(other.m_color, 0)),
+      m_depth_stencil(std::exchange(other.m_depth_stencil, 0)), m_width(other.m_width),
+      m_height(other.m_height) {}
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_color, other.m_color);
+    std::swap(m_depth_stencil, other.m_depth_stencil);
+    std::swap(m_width, other.m_width);
+    std::swap(m_height, other.m_height);
+    return *this;
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_handle);
+    glViewport(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height));
+}
+
+void Framebuffer::unbind() const { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+bool Framebuffer::resize(uint32_t width, uint32_t height) {
+    if (width == m_width && height == m_height)
+        return true;
+
+    release();
+    m_width = width;
+    m_height = height;
+    return createAttachments();
+}
+
+std::vector<uint8_t> Framebuffer::readPixels() const {
+    std::vector<uint8_t> pixels(static_cast<size_t>(m_width) * m_height * 4);
+
+    glNamedFramebufferReadBuffer(m_handle, GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_handle);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadnPixels(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height), GL_RGBA,
+                  GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    return pixels;
+}
+
+bool Framebuffer::createAttachments() {
+    auto width = static_cast<GLsizei>(m_width);
+    auto height = static_cast<GLsizei>(m_height);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_color);
+    glTextureStorage2D(m_color, 1, GL_RGBA8, width, height);
+    glTextureParameteri(m_color, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_color, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_color, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_color, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glCreateRenderbuffers(1, &m_depth_stencil);
+    glNamedRenderbufferStorage(m_depth_stencil, GL_DEPTH24_STENCIL8, width, height);
+
+    glCreateFramebuffers(1, &m_handle);
+    glNamedFramebufferTexture(m_handle, GL_COLOR_ATTACHMENT0, m_color, 0);
+    glNamedFramebufferRenderbuffer(m_handle, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                   m_depth_stencil);
+
+    GLenum status = glCheckNamedFramebufferStatus(m_handle, GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer incomplete: 0x" << std::hex << status << std::dec << "\n";
+        release();
+        return false;
+    }
+    return true;
+}
+
+void Framebuffer::release() {
+    glDeleteFramebuffers(1, &m_handle);
+    glDeleteRenderbuffers(1, &m_depth_stencil);
+    glDeleteTextures(1, &m_color);
+    m_handle = m_depth_stencil = m_color = 0;
+}
+
+} // namespace mamba::Renderer
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+struct FramebufferSpecification {
+    uint32_t width;
+    uint32_t height;
+};
+
+/// Offscreen render target with an RGBA8 color texture and a depth-stencil renderbuffer.
+/// Headless contexts have no default framebuffer, everything is drawn into one of these.
+class Framebuffer {
+  public:
+    // Empty if the driver rejects the attachments
+    static std::optional<Framebuffer> create(const FramebufferSpecification& spec);
+
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+    Framebuffer(Framebuffer&&) noexcept;
+    Framebuffer& operator=(Framebuffer&&) noexcept;
+
+    // Also sets the viewport to cover the whole target
+    void bind() const;
+    void unbind() const;
+
+    // Recreates the attachments, their contents are lost
+    bool resize(uint32_t width, uint32_t height);
+
+    // RGBA8, rows bottom first like OpenGL returns them
+    std::vector<uint8_t> readPixels() const;
+
+    GLuint handle() const { return m_handle; }
+    GLuint colorAttachment() const { return m_color; }
+    uint32_t width() const { return m_width; }
+    uint32_t height() const { return m_height; }
+
+  private:
+    Framebuffer() = default;
+
+    bool createAttachments();
+    void release();
+
+    GLuint m_handle{0};
+    GLuint m_color{0};
+    GLuint m_depth_stencil{0};
+    uint32_t m_width{0};
+    uint32_t m_height{0};
+};
+
+} // namespace mamba::Renderer
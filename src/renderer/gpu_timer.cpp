@@ -0,0 +1,46 @@
+#include "gpu_timer.hpp"
+
+namespace mamba::Renderer {
+
+GpuTimer::GpuTimer() { glCreateQueries(GL_TIME_ELAPSED, QUERY_COUNT, m_queries.data()); }
+
+GpuTimer::~GpuTimer() { glDeleteQueries(QUERY_COUNT, m_queries.data()); }
+
+void GpuTimer::begin() {
+    // Every query is still in flight, the oldest result has to be read before reuse
+    if (m_pending == QUERY_COUNT) {
+        GLuint64 discarded;
+        glGetQueryObjectui64v(m_queries[m_oldest], GL_QUERY_RESULT, &discarded);
+        m_oldest = (m_oldest + 1) % QUERY_COUNT;
+        --m_pending;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[(m_oldest + m_pending) % QUERY_COUNT]);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    ++m_pending;
+}
+
+std::vector<double> GpuTimer::collect(bool wait) {
+    std::vector<double> results;
+    while (m_pending > 0) {
+        GLuint query = m_queries[m_oldest];
+        if (!wait) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        results.push_back(static_cast<double>(nanoseconds) / 1e6);
+
+        m_oldest = (m_oldest + 1) % QUERY_COUNT;
+        --m_pending;
+    }
+    return results;
+}
+
+} // namespace mamba::Renderer
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+/// Measures GPU time between begin and end with GL_TIME_ELAPSED queries. Results arrive a few
+/// frames late; a small ring of queries keeps the CPU from waiting on them.
+class GpuTimer {
+  public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // Pairs cannot nest, GL allows one active time query at a time
+    void begin();
+    void end();
+
+    // Milliseconds of every finished pair, oldest first. Only returns what is ready unless
+    // `wait` is set, which blocks until every pair so far has finished.
+    std::vector<double> collect(bool wait = false);
+
+  private:
+    static constexpr size_t QUERY_COUNT = 8;
+
+    std::array<GLuint, QUERY_COUNT> m_queries{};
+    size_t m_oldest{0};
+    size_t m_pending{0};
+};
+
+} // namespace mamba::Renderer
@@ -0,0 +1,133 @@
+#include "image_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace mamba::Renderer {
+
+namespace {
+
+constexpr auto CRC_TABLE = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < table.size(); ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}();
+
+uint32_t crc32(std::span<const uint8_t> data, uint32_t crc = 0) {
+    crc = ~crc;
+    for (uint8_t byte : data)
+        crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t adler32(std::span<const uint8_t> data) {
+    constexpr uint32_t MOD = 65521;
+    // Largest run that cannot overflow before the modulo
+    constexpr size_t NMAX = 5552;
+
+    uint32_t a = 1, b = 0;
+    for (size_t offset = 0; offset < data.size(); offset += NMAX) {
+        auto end = std::min(data.size(), offset + NMAX);
+        for (size_t i = offset; i < end; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+    return (b << 16) | a;
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putChunk(std::vector<uint8_t>& out, std::string_view type, std::span<const uint8_t> data) {
+    putU32(out, static_cast<uint32_t>(data.size()));
+    size_t type_offset = out.size();
+    out.insert(out.end(), type.begin(), type.end());
+    out.insert(out.end(), data.begin(), data.end());
+    // Covers the type and the data but not the length
+    putU32(out, crc32(std::span(out).subspan(type_offset)));
+}
+
+// zlib stream made of stored deflate blocks
+std::vector<uint8_t> zlibStore(std::span<const uint8_t> data) {
+    constexpr size_t MAX_BLOCK = 65535;
+
+    std::vector<uint8_t> out;
+    out.reserve(data.size() + data.size() / MAX_BLOCK * 5 + 16);
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    size_t offset = 0;
+    do {
+        auto length = static_cast<uint16_t>(std::min(MAX_BLOCK, data.size() - offset));
+        bool final = offset + length == data.size();
+        out.push_back(final ? 1 : 0);
+        out.push_back(static_cast<uint8_t>(length));
+        out.push_back(static_cast<uint8_t>(length >> 8));
+        out.push_back(static_cast<uint8_t>(~length));
+        out.push_back(static_cast<uint8_t>(~length >> 8));
+        out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+        offset += length;
+    } while (offset < data.size());
+
+    putU32(out, adler32(data));
+    return out;
+}
+
+} // namespace
+
+bool writePng(const std::filesystem::path& path, uint32_t width, uint32_t height,
+              std::span<const uint8_t> rgba, bool flip_vertically) {
+    size_t row_size = static_cast<size_t>(width) * 4;
+    if (width == 0 || height == 0 || rgba.size() < row_size * height) {
+        std::cerr << "Cannot write PNG, image data does not match its size: " << path.string()
+                  << "\n";
+        return false;
+    }
+
+    // Every row starts with its filter type, 0 leaves the row as is
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve((row_size + 1) * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        uint32_t row = flip_vertically ? height - 1 - y : y;
+        scanlines.push_back(0);
+        auto source = rgba.subspan(row * row_size, row_size);
+        scanlines.insert(scanlines.end(), source.begin(), source.end());
+    }
+
+    std::vector<uint8_t> header;
+    putU32(header, width);
+    putU32(header, height);
+    // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlacing
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", zlibStore(scanlines));
+    putChunk(png, "IEND", {});
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    if (!file) {
+        std::cerr << "Failed to write PNG: " << path.string() << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace mamba::Renderer
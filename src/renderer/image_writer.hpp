@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace mamba::Renderer {
+
+/// Writes RGBA8 pixels as a PNG. The image data is stored without compression, which keeps
+/// the writer tiny and fast but the files large: meant for captures and image comparisons,
+/// not for shipping assets. `flip_vertically` takes rows bottom first, as read back from GL.
+bool writePng(const std::filesystem::path& path, uint32_t width, uint32_t height,
+              std::span<const uint8_t> rgba, bool flip_vertically = false);
+
+} // namespace mamba::Renderer
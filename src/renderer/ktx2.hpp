@@ -0,0 +1,115 @@
+#pragma once
+
+// KTX 2.0 container layout, shared by the texture loader and the offline compressor.
+// Only block-compressed formats without supercompression are supported.
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include <glad/glad.h>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace mamba::Renderer::Ktx2 {
+
+inline constexpr std::array<uint8_t, 12> IDENTIFIER = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                                       0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Follows the identifier. The supercompression global data offset and length (two uint64)
+// come right after and are not needed without supercompression.
+struct Header {
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+    uint32_t dfd_byte_offset;
+    uint32_t dfd_byte_length;
+    uint32_t kvd_byte_offset;
+    uint32_t kvd_byte_length;
+};
+static_assert(sizeof(Header) == 52);
+
+inline constexpr size_t SGD_SIZE = 2 * sizeof(uint64_t);
+inline constexpr size_t LEVEL_INDEX_OFFSET = IDENTIFIER.size() + sizeof(Header) + SGD_SIZE;
+
+struct LevelIndex {
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    uint64_t uncompressed_byte_length;
+};
+static_assert(sizeof(LevelIndex) == 24);
+
+// VkFormat values of the supported block-compressed formats
+enum VkFormat : uint32_t {
+    BC1_RGB_UNORM = 131,
+    BC1_RGB_SRGB = 132,
+    BC1_RGBA_UNORM = 133,
+    BC1_RGBA_SRGB = 134,
+    BC3_UNORM = 137,
+    BC3_SRGB = 138,
+    BC7_UNORM = 145,
+    BC7_SRGB = 146,
+    ETC2_R8G8B8_UNORM = 147,
+    ETC2_R8G8B8_SRGB = 148,
+    ETC2_R8G8B8A1_UNORM = 149,
+    ETC2_R8G8B8A1_SRGB = 150,
+    ETC2_R8G8B8A8_UNORM = 151,
+    ETC2_R8G8B8A8_SRGB = 152,
+};
+
+struct FormatInfo {
+    GLenum gl_format;
+    uint32_t block_size; // Bytes per 4x4 block
+};
+
+inline std::optional<FormatInfo> findFormat(uint32_t vk_format) {
+    switch (vk_format) {
+    case BC1_RGB_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8};
+    case BC1_RGB_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 8};
+    case BC1_RGBA_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 8};
+    case BC1_RGBA_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 8};
+    case BC3_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 16};
+    case BC3_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 16};
+    case BC7_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGBA_BPTC_UNORM, 16};
+    case BC7_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 16};
+    case ETC2_R8G8B8_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGB8_ETC2, 8};
+    case ETC2_R8G8B8_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB8_ETC2, 8};
+    case ETC2_R8G8B8A1_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 8};
+    case ETC2_R8G8B8A1_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, 8};
+    case ETC2_R8G8B8A8_UNORM:
+        return FormatInfo{GL_COMPRESSED_RGBA8_ETC2_EAC, 16};
+    case ETC2_R8G8B8A8_SRGB:
+        return FormatInfo{GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, 16};
+    }
+    return std::nullopt;
+}
+
+} // namespace mamba::Renderer::Ktx2
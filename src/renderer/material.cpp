@@ -0,0 +1,85 @@
+#include "material.hpp"
+
+#include "shaders/shaders.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace mamba::Renderer {
+
+Material::Material(const Shader& shader) : m_shader(&shader) {
+    GLuint program = shader.handle();
+
+    if (const auto* block = shader.findUniformBlock("Material")) {
+        glUniformBlockBinding(program, block->index, UNIFORM_BINDING);
+        m_uniform_data.resize(block->size);
+        m_ubo.emplace(m_uniform_data.size());
+        m_dirty = true;
+    }
+
+    // Same units as the built-in quad shader, so the texture given to drawQuad is readable
+    GLint quad_textures = 0;
+    if (const auto* textures = shader.findUniform("uTextures"); textures && textures->sampler) {
+        quad_textures = textures->array_size;
+        std::vector<GLint> units(textures->array_size);
+        std::iota(units.begin(), units.end(), 0);
+        glProgramUniform1iv(program, textures->location, static_cast<GLsizei>(units.size()),
+                            units.data());
+    }
+
+    // The fragment stage can only read so many textures, uTextures included
+    GLint max_units = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_units);
+    m_max_textures = static_cast<uint32_t>(
+        std::clamp<GLint>(max_units - quad_textures, 0, static_cast<GLint>(MAX_TEXTURES)));
+}
+
+ShaderResult Material::createShader(std::string_view fragment_source) {
+    return Shader::createFromSource(Shaders::QUAD_VERT, fragment_source);
+}
+
+bool Material::setUniformData(std::span<const std::byte> data) {
+    if (m_uniform_data.empty())
+        return false;
+
+    std::copy_n(data.begin(), std::min(data.size(), m_uniform_data.size()),
+                m_uniform_data.begin());
+    m_dirty = true;
+    return true;
+}
+
+bool Material::setTexture(std::string_view name, const Texture& texture) {
+    const auto* uniform = m_shader->findUniform(name);
+    if (!uniform || !uniform->sampler)
+        return false;
+
+    auto end = m_textures.begin() + m_texture_count;
+    auto slot = std::ranges::find(m_textures.begin(), end, uniform->location,
+                                  &TextureSlot::location);
+    if (slot == end) {
+        if (m_texture_count >= m_max_textures)
+            return false;
+        glProgramUniform1i(m_shader->handle(), uniform->location,
+                           TEXTURE_UNIT_BASE + m_texture_count);
+        ++m_texture_count;
+    }
+    *slot = {uniform->location, texture.handle(), texture.sampler()};
+    return true;
+}
+
+void Material::bind() const {
+    if (m_dirty) {
+        m_ubo->update(m_uniform_data);
+        m_dirty = false;
+    }
+
+    glUseProgram(m_shader->handle());
+    if (m_ubo)
+        m_ubo->bind(UNIFORM_BINDING);
+    for (uint32_t i = 0; i < m_texture_count; ++i) {
+        glBindTextureUnit(TEXTURE_UNIT_BASE + i, m_textures[i].texture);
+        glBindSampler(TEXTURE_UNIT_BASE + i, m_textures[i].sampler);
+    }
+}
+
+} // namespace mamba::Renderer
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "renderer/gpu_buffer.hpp"
+#include "renderer/shader.hpp"
+#include "renderer/texture.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+/// A user shader and the parameters it draws with, for effects the built-in quad shader cannot
+/// express. Quads drawn with the same material share a batch, the renderer only starts a new
+/// draw call when the material changes.
+///
+/// The shader runs on the quad vertex stage (see createShader) and may declare
+///  - `layout(std140, binding = 1) uniform Material { ... }` for its parameters,
+///  - samplers of its own, assigned with setTexture to units from TEXTURE_UNIT_BASE up,
+///  - `uniform sampler2D uTextures[16]` to read the texture passed to drawQuad, like quad.frag.
+///
+/// All samplers of the shader count against GL_MAX_TEXTURE_IMAGE_UNITS, which is only
+/// guaranteed to be 16. Declaring uTextures takes all 16 of those, so on such drivers a shader
+/// cannot also have samplers of its own and setTexture returns false.
+///
+/// Parameters and textures are applied when the batch is flushed, so every quad drawn with a
+/// material in a frame sees its last values. Quads that need different values need different
+/// materials.
+class Material {
+  public:
+    static constexpr uint32_t MAX_TEXTURES = 8;
+    // Units below are taken by the quad batch
+    static constexpr GLuint TEXTURE_UNIT_BASE = 16;
+    // Binding 0 holds the camera
+    static constexpr GLuint UNIFORM_BINDING = 1;
+
+    // The shader is not owned and has to outlive the material
+    explicit Material(const Shader& shader);
+
+    Material(const Material&) = delete;
+    Material& operator=(const Material&) = delete;
+    Material(Material&&) noexcept = default;
+    Material& operator=(Material&&) noexcept = default;
+
+    // Links `fragment_source` against the vertex stage the quad batch draws with
+    static ShaderResult createShader(std::string_view fragment_source);
+
+    const Shader& shader() const { return *m_shader; }
+
+    // Copies into the Material block, truncated to its size. False if the shader has no block.
+    bool setUniformData(std::span<const std::byte> data);
+
+    // `T` has to match the std140 layout of the block
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool setUniforms(const T& data) {
+        return setUniformData(std::as_bytes(std::span(&data, 1)));
+    }
+
+    // False if the shader has no sampler called `name`, every texture unit is taken or the
+    // shader would read more textures than the driver allows
+    bool setTexture(std::string_view name, const Texture& texture);
+
+  private:
+    friend class Renderer2D;
+
+    // Uploads changed parameters, then binds the program, block and textures
+    void bind() const;
+
+    struct TextureSlot {
+        GLint location;
+        GLuint texture;
+        GLuint sampler;
+    };
+
+    const Shader* m_shader;
+    std::vector<std::byte> m_uniform_data;
+    mutable std::optional<UniformBuffer<std::byte>> m_ubo;
+    mutable bool m_dirty{false};
+    std::array<TextureSlot, MAX_TEXTURES> m_textures{};
+    uint32_t m_texture_count{0};
+    uint32_t m_max_textures{0}; // Fewer than MAX_TEXTURES when uTextures uses up the driver limit
+};
+
+} // namespace mamba::Renderer
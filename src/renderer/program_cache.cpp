@@ -0,0 +1,191 @@
+#include "program_cache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace mamba::Renderer {
+
+namespace {
+
+constexpr uint32_t MAGIC = 0x4250534d; // "MSPB"
+// Every edit of a hot reloaded shader adds a binary, the least recently used ones go first
+constexpr size_t MAX_ENTRIES = 256;
+
+struct BinaryHeader {
+    uint32_t magic;
+    uint32_t format;
+    uint32_t length;
+};
+
+uint64_t fnv1a(std::string_view data, uint64_t hash = 0xcbf29ce484222325) {
+    for (char c : data) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    // Separates consecutive strings, so ("ab", "c") and ("a", "bc") hash differently
+    return (hash ^ 0xff) * 0x100000001b3;
+}
+
+std::filesystem::path userCacheDirectory() {
+    auto env = [](const char* name) -> std::filesystem::path {
+        const char* value = std::getenv(name);
+        return value && *value ? value : "";
+    };
+
+#if defined(_WIN32)
+    return env("LOCALAPPDATA");
+#elif defined(__APPLE__)
+    auto home = env("HOME");
+    return home.empty() ? home : home / "Library" / "Caches";
+#else
+    auto xdg = env("XDG_CACHE_HOME");
+    if (!xdg.empty())
+        return xdg;
+    auto home = env("HOME");
+    return home.empty() ? home : home / ".cache";
+#endif
+}
+
+std::string glString(GLenum name) {
+    auto value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? value : "";
+}
+
+} // namespace
+
+ProgramCache::ProgramCache() {
+    const char* setting = std::getenv("MAMBA_SHADER_CACHE");
+    if (setting && std::string_view(setting) == "0")
+        return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+        return;
+
+    auto base = userCacheDirectory();
+    if (base.empty())
+        return;
+
+    std::error_code error;
+    m_directory = base / "mamba" / "shaders";
+    std::filesystem::create_directories(m_directory, error);
+    if (error)
+        return;
+
+    m_driver = glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' + glString(GL_VERSION);
+    m_enabled = true;
+}
+
+uint64_t ProgramCache::key(std::string_view vertex_source,
+                           std::string_view fragment_source) const {
+    return fnv1a(m_driver, fnv1a(fragment_source, fnv1a(vertex_source)));
+}
+
+std::filesystem::path ProgramCache::path(uint64_t key) const {
+    return m_directory / std::format("{:016x}.bin", key);
+}
+
+GLuint ProgramCache::load(uint64_t key) const {
+    if (!m_enabled)
+        return 0;
+
+    auto file_path = path(key);
+    std::ifstream file(file_path, std::ios::binary);
+    std::error_code error;
+    auto file_size = std::filesystem::file_size(file_path, error);
+    if (!file || error)
+        return 0;
+
+    // The length is checked against the file so a corrupt header cannot size the buffer
+    BinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != MAGIC || header.length != file_size - sizeof(header))
+        return 0;
+
+    std::vector<char> binary(header.length);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers reject binaries from older versions of themselves, which is expected after an
+    // update. The stale file is overwritten once the program is compiled again.
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    // Marks the binary as recently used, prune removes the oldest ones
+    std::filesystem::last_write_time(file_path, std::filesystem::file_time_type::clock::now(),
+                                     error);
+    return program;
+}
+
+void ProgramCache::store(uint64_t key, GLuint program) const {
+    if (!m_enabled)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // Written next to the final name and renamed, so a concurrent run never reads half a file
+    auto final_path = path(key);
+    auto temp_path = final_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary);
+        BinaryHeader header{MAGIC, format, static_cast<uint32_t>(length)};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file)
+            return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, final_path, error);
+    if (error)
+        std::filesystem::remove(temp_path, error);
+
+    prune();
+}
+
+void ProgramCache::prune() const {
+    struct Binary {
+        std::filesystem::path path;
+        std::filesystem::file_time_type time;
+    };
+
+    std::error_code error;
+    std::vector<Binary> binaries;
+    std::filesystem::directory_iterator file(m_directory, error), end;
+    for (; !error && file != end; file.increment(error)) {
+        if (file->path().extension() != ".bin")
+            continue;
+        std::error_code time_error;
+        auto time = file->last_write_time(time_error);
+        if (!time_error)
+            binaries.push_back({file->path(), time});
+    }
+    if (binaries.size() <= MAX_ENTRIES)
+        return;
+
+    // Newest first, everything past the limit is removed
+    std::ranges::sort(binaries, std::ranges::greater{}, &Binary::time);
+    for (size_t i = MAX_ENTRIES; i < binaries.size(); ++i)
+        std::filesystem::remove(binaries[i].path, error);
+}
+
+} // namespace mamba::Renderer
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+/// Linked program binaries kept on disk between runs, in <user cache dir>/mamba/shaders.
+/// Binaries only load on the driver that produced them, so the key covers the vendor,
+/// renderer and version strings next to the sources. Every failure is silent and reported as
+/// a miss, the caller then compiles as usual. Storing a binary removes the least recently used
+/// ones beyond a fixed count, so shader edits do not pile up.
+class ProgramCache {
+  public:
+    // Needs a current context. Disabled when the driver exposes no binary formats or no cache
+    // directory can be found; set MAMBA_SHADER_CACHE=0 to disable it explicitly.
+    ProgramCache();
+
+    bool isEnabled() const { return m_enabled; }
+
+    uint64_t key(std::string_view vertex_source, std::string_view fragment_source) const;
+
+    // Returns a linked program, or 0 on a miss or when the driver rejects the binary
+    GLuint load(uint64_t key) const;
+    // The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+    void store(uint64_t key, GLuint program) const;
+
+  private:
+    std::filesystem::path path(uint64_t key) const;
+    void prune() const;
+
+    bool m_enabled{false};
+    std::filesystem::path m_directory;
+    std::string m_driver;
+};
+
+} // namespace mamba::Renderer
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <numeric>
 #include <span>
+#include <stdexcept>
 
 namespace mamba::Renderer {
 
@@ -41,12 +42,33 @@ Renderer2D::Renderer2D() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    m_shader = Shader::createFromSource(Shaders::QUAD_VERT, Shaders::QUAD_FRAG);
-    m_text_shader = Shader::createFromSource(Shaders::TEXT_VERT, Shaders::TEXT_FRAG);
-    m_circle_shader = Shader::createFromSource(Shaders::CIRCLE_VERT, Shaders::CIRCLE_FRAG);
+    constexpr ShaderSource sources[] = {
+        {Shaders::QUAD_VERT, Shaders::QUAD_FRAG},
+        {Shaders::TEXT_VERT, Shaders::TEXT_FRAG},
+        {Shaders::CIRCLE_VERT, Shaders::CIRCLE_FRAG},
+    };
+    auto shaders = Shader::createFromSources(sources);
+    // The built-in shaders ship with the renderer, nothing can be drawn without them
+    for (const auto& shader : shaders) {
+        if (!shader)
+            throw std::runtime_error("Failed to compile built-in shader: " + shader.error());
+    }
+    m_shader = std::move(*shaders[0]);
+    m_text_shader = std::move(*shaders[1]);
+    m_circle_shader = std::move(*shaders[2]);
+
+#ifdef MAMBA_SHADER_HOT_RELOAD
+    const std::filesystem::path shader_dir = MAMBA_SHADER_DIR;
+    m_shader_library.watch(shader_dir / "quad.vert", shader_dir / "quad.frag");
+    m_shader_library.watch(shader_dir / "text.vert", shader_dir / "text.frag");
+    m_shader_library.watch(shader_dir / "circle.vert", shader_dir / "circle.frag");
+    m_watched_shaders = {&m_shader, &m_text_shader, &m_circle_shader};
+#endif
     m_quad_vertices.reserve(MAX_VERTICES);
+    m_quad_runs.reserve(64);
     m_text_vertices.reserve(MAX_VERTICES);
     m_circle_vertices.reserve(MAX_VERTICES);
+    m_text_format_buffer.reserve(256);
 
     // Create shared EBO
     m_ebo.emplace(getIndices());
@@ -69,9 +91,9 @@ Renderer2D::Renderer2D() {
     // Create text VAO
     {
         mamba::Renderer::VertexLayout layout = {
-            {ShaderDataType::Float4, 0},
-            {ShaderDataType::Float2, 1},
-            {ShaderDataType::Float4, 2},
+            {ShaderDataType::Float4, 0}, {ShaderDataType::Float2, 1}, {ShaderDataType::Float4, 2},
+            {ShaderDataType::Float4, 3}, {ShaderDataType::Float4, 4}, {ShaderDataType::Float4, 5},
+            {ShaderDataType::Float2, 6}, {ShaderDataType::Float3, 7},
         };
         VertexBuffer<TextVertex> buffer{MAX_VERTICES};
         m_text_vbo.emplace(std::move(buffer));
@@ -90,19 +112,39 @@ Renderer2D::Renderer2D() {
         m_circle_vao.addIndexBuffer(*m_ebo);
     }
 
+    applyShaderUniforms();
+
+    m_white_texture = Texture::createWhite();
+}
+
+void Renderer2D::applyShaderUniforms() {
+    // Looked up by name so edited shaders may move or drop uniforms, -1 is ignored by glUniform*
     {
         m_shader->bind();
-        glUniform1iv(1, MAX_TEXTURES, getSamplers().data());
+        glUniform1iv(m_shader->getUniformLocation("uTextures"), MAX_TEXTURES,
+                     getSamplers().data());
         m_shader->unbind();
     }
 
     {
         m_text_shader->bind();
-        glUniform1i(1, 0);
+        glUniform1i(m_text_shader->getUniformLocation("uTexture"), 0);
+        m_text_pixel_range_location = m_text_shader->getUniformLocation("uPixelRange");
+        m_text_distance_in_alpha_location = m_text_shader->getUniformLocation("uDistanceInAlpha");
         m_text_shader->unbind();
     }
+}
 
-    m_white_texture = Texture::createWhite();
+void Renderer2D::reloadShaders() {
+#ifdef MAMBA_SHADER_HOT_RELOAD
+    auto reloaded = m_shader_library.update();
+    for (auto& [id, shader] : reloaded) {
+        *m_watched_shaders[id] = std::move(shader);
+    }
+    // Uniforms live in the program object, a fresh program starts from zero
+    if (!reloaded.empty())
+        applyShaderUniforms();
+#endif
 }
 
 void Renderer2D::begin(const OrthographicCamera& camera) {
@@ -110,6 +152,7 @@ void Renderer2D::begin(const OrthographicCamera& camera) {
 
     m_ubo->bind(0);
     m_ubo->update(std::span(&data, 1));
+    m_stats.bytes_uploaded += sizeof(data);
 
     startBatch();
 }
@@ -117,33 +160,46 @@ void Renderer2D::begin(const OrthographicCamera& camera) {
 void Renderer2D::end() { flush(); }
 
 void Renderer2D::flush() {
-
-    {
-        // if (m_quad_vertices.empty())
-        //     return;
-
-        m_shader->bind();
+    // Empty batches are skipped, so stats only count draws that put something on screen
+    if (!m_quad_vertices.empty()) {
         m_vao.bind();
 
-        for (size_t i = 0; i < m_texture_idx; i++)
+        for (size_t i = 0; i < m_texture_idx; i++) {
             glBindTextureUnit(i, m_texture_slots[i]);
+            glBindSampler(i, m_sampler_slots[i]);
+        }
 
         m_vbo->update(m_quad_vertices);
-        auto indices_count = m_quad_vertices.size() / 4 * 6;
-
-        glDrawElements(GL_TRIANGLES, indices_count, GL_UNSIGNED_INT, nullptr);
+        m_stats.bytes_uploaded += m_quad_vertices.size() * sizeof(QuadVertex);
+
+        // One upload for the whole batch, runs only switch the program and draw their range
+        for (const auto& run : m_quad_runs) {
+            if (run.material) {
+                if (run.material->m_dirty)
+                    m_stats.bytes_uploaded += run.material->m_uniform_data.size();
+                run.material->bind();
+            } else {
+                m_shader->bind();
+            }
+
+            auto offset = static_cast<uintptr_t>(run.first_quad) * 6 * sizeof(uint32_t);
+            glDrawElements(GL_TRIANGLES, run.quad_count * 6, GL_UNSIGNED_INT,
+                           reinterpret_cast<const void*>(offset));
+            ++m_stats.draw_calls;
+        }
         m_vao.unbind();
         m_shader->unbind();
+        m_stats.quads += m_quad_vertices.size() / 4;
     }
 
-    {
-        // if (m_text_vertices.empty())
-        //     return;
-
+    if (!m_text_vertices.empty()) {
         m_text_shader->bind();
         m_text_vao.bind();
 
         glBindTextureUnit(0, m_text_texture_slot);
+        glBindSampler(0, m_text_sampler_slot);
+        glUniform1f(m_text_pixel_range_location, m_text_pixel_range);
+        glUniform1i(m_text_distance_in_alpha_location, m_text_distance_in_alpha);
 
         m_text_vbo->update(m_text_vertices);
         auto indices_count = m_text_vertices.size() / 4 * 6;
@@ -151,12 +207,13 @@ void Renderer2D::flush() {
         glDrawElements(GL_TRIANGLES, indices_count, GL_UNSIGNED_INT, nullptr);
         m_text_vao.unbind();
         m_text_shader->unbind();
-    }
 
-    {
-        // if (m_text_vertices.empty())
-        //     return;
+        ++m_stats.draw_calls;
+        m_stats.glyphs += m_text_vertices.size() / 4;
+        m_stats.bytes_uploaded += m_text_vertices.size() * sizeof(TextVertex);
+    }
 
+    if (!m_circle_vertices.empty()) {
         m_circle_shader->bind();
         m_circle_vao.bind();
 
@@ -166,8 +223,13 @@ void Renderer2D::flush() {
         glDrawElements(GL_TRIANGLES, indices_count, GL_UNSIGNED_INT, nullptr);
         m_circle_vao.unbind();
         m_circle_shader->unbind();
+
+        ++m_stats.draw_calls;
+        m_stats.circles += m_circle_vertices.size() / 4;
+        m_stats.bytes_uploaded += m_circle_vertices.size() * sizeof(CircleVertex);
     }
 }
+
 void Renderer2D::drawCircle(const glm::mat4& transform, const glm::vec4& color) {
 
     if (m_circle_vertices.size() >= MAX_VERTICES) {
@@ -199,17 +261,40 @@ void Renderer2D::drawCircle(const glm::mat4& transform, const glm::vec4& color)
 
 void Renderer2D::drawQuad(const glm::mat4& transform, const Texture& texture,
                           const glm::vec4& tint_color) {
+    submitQuad(transform, texture, {0.0f, 0.0f}, {1.0f, 1.0f}, tint_color);
+}
 
-    if (m_quad_vertices.size() >= MAX_VERTICES) {
-        nextBatch();
-    }
+void Renderer2D::drawQuad(const glm::mat4& transform, const SubTexture& texture,
+                          const glm::vec4& tint_color) {
+    submitQuad(transform, *texture.texture, texture.uv_min, texture.uv_max, tint_color);
+}
 
-    if (m_texture_idx >= MAX_TEXTURES) {
+void Renderer2D::drawQuad(const glm::mat4& transform, const Material& material,
+                          const glm::vec4& color) {
+    submitQuad(transform, *m_white_texture, {0.0f, 0.0f}, {1.0f, 1.0f}, color, &material);
+}
+
+void Renderer2D::drawQuad(const glm::mat4& transform, const Material& material,
+                          const Texture& texture, const glm::vec4& tint_color) {
+    submitQuad(transform, texture, {0.0f, 0.0f}, {1.0f, 1.0f}, tint_color, &material);
+}
+
+void Renderer2D::drawQuad(const glm::mat4& transform, const Material& material,
+                          const SubTexture& texture, const glm::vec4& tint_color) {
+    submitQuad(transform, *texture.texture, texture.uv_min, texture.uv_max, tint_color, &material);
+}
+
+void Renderer2D::submitQuad(const glm::mat4& transform, const Texture& texture,
+                            const glm::vec2& uv_min, const glm::vec2& uv_max,
+                            const glm::vec4& tint_color, const Material* material) {
+
+    if (m_quad_vertices.size() >= MAX_VERTICES) {
         nextBatch();
     }
 
     constexpr size_t vertex_count = 4;
-    constexpr glm::vec2 texture_coords[] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    const glm::vec2 texture_coords[] = {
+        {uv_min.x, uv_min.y}, {uv_max.x, uv_min.y}, {uv_max.x, uv_max.y}, {uv_min.x, uv_max.y}};
     constexpr glm::vec4 quad_vertices[] = {
         {-0.5, -0.5, 0.0, 1.0},
         {0.5, -0.5, 0.0, 1.0},
@@ -217,7 +302,19 @@ void Renderer2D::drawQuad(const glm::mat4& transform, const Texture& texture,
         {-0.5, 0.5, 0.0, 1.0},
     };
 
+    // Only break the batch when every slot holds a different texture
     auto tex_idx = insertTexture(texture);
+    if (tex_idx < 0) {
+        nextBatch();
+        tex_idx = insertTexture(texture);
+    }
+
+    // Only break the draw when the program changes
+    if (m_quad_runs.empty() || m_quad_runs.back().material != material) {
+        auto first_quad = static_cast<uint32_t>(m_quad_vertices.size() / vertex_count);
+        m_quad_runs.push_back({material, first_quad, 0});
+    }
+    ++m_quad_runs.back().quad_count;
 
     for (size_t i = 0; i < vertex_count; i++) {
         QuadVertex vertex{.position = transform * quad_vertices[i],
@@ -248,6 +345,14 @@ void Renderer2D::drawQuad(const glm::vec2& position, const glm::vec2& size, cons
     drawQuad(transform, texture, tint);
 }
 
+void Renderer2D::drawQuad(const glm::vec2& position, const glm::vec2& size,
+                          const SubTexture& texture, const glm::vec4& tint) {
+    glm::mat4 transform(1.0f);
+    transform = glm::translate(transform, glm::vec3(position, 0.0f));
+    transform = glm::scale(transform, glm::vec3(size, 1.0f));
+    drawQuad(transform, texture, tint);
+}
+
 int Renderer2D::insertTexture(const Texture& texture) {
 
     auto end = m_texture_slots.begin() + m_texture_idx;
@@ -255,7 +360,11 @@ int Renderer2D::insertTexture(const Texture& texture) {
     if (iter != end) {
         return std::distance(m_texture_slots.begin(), iter);
     }
+    if (m_texture_idx >= MAX_TEXTURES) {
+        return -1;
+    }
     m_texture_slots[m_texture_idx] = texture.handle();
+    m_sampler_slots[m_texture_idx] = texture.sampler();
     return m_texture_idx++;
 }
 
@@ -269,6 +378,7 @@ void Renderer2D::setViewPort(uint32_t width, uint32_t height) { glViewport(0, 0,
 
 void Renderer2D::startBatch() {
     m_quad_vertices.clear();
+    m_quad_runs.clear();
     m_texture_idx = 0;
 
     m_text_vertices.clear();
@@ -282,60 +392,91 @@ void Renderer2D::nextBatch() {
 
 void Renderer2D::drawText(std::string_view text, const Font& font, const glm::vec2& position,
                           float scale, const glm::vec4& color) {
-    if (m_text_vertices.size() >= MAX_VERTICES) {
-        nextBatch();
-    }
-    const auto& atlas = font.getAtlasTexture();
-    m_text_texture_slot = atlas.handle();
-
-    const auto& geometry = font.getFontGeometry();
-    const auto& metrics = geometry.getMetrics();
+    drawText(text, font, position, scale, TextStyle{.color = color});
+}
 
-    double x = position.x;
-    double y = position.y;
+void Renderer2D::drawText(std::string_view text, const Font& font, const glm::vec2& position,
+                          float scale, const TextStyle& style) {
+    useFont(font);
 
-    double fsScale = scale / metrics.lineHeight;
+    glm::vec2 pen = position;
+    float fsScale = scale / font.getLineHeight();
 
-    for (auto c : text) {
-        if (c == '\n') {
-            x = position.x;
-            y -= metrics.lineHeight * fsScale;
+    for (size_t index = 0; index < text.size();) {
+        uint32_t codepoint = nextCodepoint(text, index);
+        if (codepoint == '\n') {
+            pen.x = position.x;
+            pen.y -= scale;
             continue;
         }
 
-        auto glyph = geometry.getGlyph(c);
+        const Font::Glyph* glyph = font.getGlyph(codepoint);
         if (!glyph)
             continue;
 
-        // Get glyph bounds in atlas (normalized 0-1)
-        double al, ab, ar, at; // atlas left, bottom, right, top
-        glyph->getQuadAtlasBounds(al, ab, ar, at);
+        // Convert em units to screen coordinates
+        pushGlyph(glm::vec4{pen, pen} + glyph->plane * fsScale, glyph->uv, style);
 
-        // Get glyph bounds in output (em units)
-        double pl, pb, pr, pt; // plane left, bottom, right, top
-        glyph->getQuadPlaneBounds(pl, pb, pr, pt);
+        // Advance cursor
+        pen.x += glyph->advance * fsScale;
+    }
+}
 
-        // Convert to screen coordinates
-        float x0 = static_cast<float>(x + pl * fsScale);
-        float y0 = static_cast<float>(y + pb * fsScale);
-        float x1 = static_cast<float>(x + pr * fsScale);
-        float y1 = static_cast<float>(y + pt * fsScale);
+void Renderer2D::drawText(const TextLayout& layout, const glm::vec2& position, float scale,
+                          const glm::vec4& color) {
+    drawText(layout, position, scale, TextStyle{.color = color});
+}
 
-        // Normalize atlas coords
-        float u0 = static_cast<float>(al / atlas.width());
-        float v0 = static_cast<float>(ab / atlas.height());
-        float u1 = static_cast<float>(ar / atlas.width());
-        float v1 = static_cast<float>(at / atlas.height());
+void Renderer2D::drawText(const TextLayout& layout, const glm::vec2& position, float scale,
+                          const TextStyle& style) {
+    const Font* font = layout.getFont();
+    if (!font)
+        return;
+    useFont(*font);
 
-        // Create quad (4 vertices)
-        m_text_vertices.push_back({{x0, y0, 0.0f, 1.0f}, {u0, v0}, color});
-        m_text_vertices.push_back({{x1, y0, 0.0f, 1.0f}, {u1, v0}, color});
-        m_text_vertices.push_back({{x1, y1, 0.0f, 1.0f}, {u1, v1}, color});
-        m_text_vertices.push_back({{x0, y1, 0.0f, 1.0f}, {u0, v1}, color});
+    float fsScale = scale / font->getLineHeight();
+    glm::vec4 origin{position, position};
 
-        // Advance cursor
-        double advance = glyph->getAdvance();
-        x += advance * fsScale;
+    for (const auto& quad : layout.getQuads()) {
+        pushGlyph(origin + quad.plane * fsScale, quad.uv, style);
     }
 }
+
+void Renderer2D::useFont(const Font& font) {
+    const auto& atlas = font.getAtlasTexture();
+
+    // A text batch samples a single atlas with a single pixel range
+    bool font_changed = !m_text_vertices.empty() && m_text_texture_slot != atlas.handle();
+    if (font_changed) {
+        nextBatch();
+    }
+    m_text_texture_slot = atlas.handle();
+    m_text_sampler_slot = atlas.sampler();
+    m_text_pixel_range = font.getPixelRange();
+    m_text_distance_in_alpha = font.getAtlasFormat() != FontAtlasFormat::MSDF;
+}
+
+void Renderer2D::pushGlyph(const glm::vec4& plane, const glm::vec4& uv, const TextStyle& style) {
+    if (m_text_vertices.size() >= MAX_VERTICES) {
+        nextBatch();
+    }
+
+    glm::vec3 effect_params{style.outline_width, style.shadow_softness, style.glow_width};
+    auto push_vertex = [&](const glm::vec4& vertex_position, const glm::vec2& tex_coords) {
+        m_text_vertices.push_back({.position = vertex_position,
+                                   .tex_coords = tex_coords,
+                                   .color = style.color,
+                                   .outline_color = style.outline_color,
+                                   .shadow_color = style.shadow_color,
+                                   .glow_color = style.glow_color,
+                                   .shadow_offset = style.shadow_offset,
+                                   .effect_params = effect_params});
+    };
+
+    // Create quad (4 vertices)
+    push_vertex({plane.x, plane.y, 0.0f, 1.0f}, {uv.x, uv.y});
+    push_vertex({plane.z, plane.y, 0.0f, 1.0f}, {uv.z, uv.y});
+    push_vertex({plane.z, plane.w, 0.0f, 1.0f}, {uv.z, uv.w});
+    push_vertex({plane.x, plane.w, 0.0f, 1.0f}, {uv.x, uv.w});
+}
 } // namespace mamba::Renderer
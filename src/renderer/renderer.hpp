@@ -4,18 +4,53 @@
 #include "renderer/camera.hpp"
 #include "renderer/font.hpp"
 #include "renderer/gpu_buffer.hpp"
+#include "renderer/material.hpp"
+#include "renderer/sampler_cache.hpp"
 #include "renderer/shader.hpp"
+#include "renderer/shader_library.hpp"
+#include "renderer/text_layout.hpp"
 #include "renderer/texture.hpp"
+#include "renderer/texture_atlas.hpp"
 #include "renderer/vertex_array.hpp"
 
 #include <array>
 #include <cstdint>
+#include <format>
+#include <iterator>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
 
 namespace mamba {
 namespace Renderer {
 
+/// Per-draw text appearance. Effects are evaluated from the font's distance field in the same
+/// draw as the glyph fill, so widths and offsets can reach at most half the atlas pixel range
+/// past the glyph edge.
+struct TextStyle {
+    glm::vec4 color{1.0f};
+
+    glm::vec4 outline_color{0.0f};
+    float outline_width{0.0f}; // Fraction of the distance range outside the glyph (0-1)
+
+    glm::vec4 shadow_color{0.0f};
+    glm::vec2 shadow_offset{0.0f}; // In atlas pixels
+    float shadow_softness{0.0f};   // Fraction of the distance range (0-1)
+
+    glm::vec4 glow_color{0.0f};
+    float glow_width{0.0f}; // Fraction of the distance range outside the glyph (0-1)
+};
+
+/// Work submitted since the last resetStats
+struct RendererStats {
+    uint32_t draw_calls;
+    uint32_t quads;
+    uint32_t circles;
+    uint32_t glyphs;
+    uint64_t bytes_uploaded; // Vertex and uniform data sent to the GPU
+};
+
 class Renderer2D {
 
     struct QuadVertex {
@@ -29,6 +64,11 @@ class Renderer2D {
         glm::vec4 position;
         glm::vec2 tex_coords;
         glm::vec4 color;
+        glm::vec4 outline_color;
+        glm::vec4 shadow_color;
+        glm::vec4 glow_color;
+        glm::vec2 shadow_offset;
+        glm::vec3 effect_params; // outline width, shadow softness, glow width
     };
 
     struct CircleVertex {
@@ -43,6 +83,13 @@ class Renderer2D {
         glm::mat4 view_projection;
     };
 
+    // Consecutive quads drawn with one program. Null material means the built-in quad shader.
+    struct QuadRun {
+        const Material* material;
+        uint32_t first_quad;
+        uint32_t quad_count;
+    };
+
   public:
     Renderer2D();
 
@@ -56,17 +103,62 @@ class Renderer2D {
     void drawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
     void drawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture,
                   const glm::vec4& tint);
+    void drawQuad(const glm::mat4&, const SubTexture&, const glm::vec4&);
+    void drawQuad(const glm::vec2& position, const glm::vec2& size, const SubTexture& texture,
+                  const glm::vec4& tint);
+    // Consecutive quads with the same material share a draw call.
+    // The material has to stay alive until the batch is flushed.
+    void drawQuad(const glm::mat4&, const Material&, const glm::vec4&);
+    void drawQuad(const glm::mat4&, const Material&, const Texture&, const glm::vec4&);
+    void drawQuad(const glm::mat4&, const Material&, const SubTexture&, const glm::vec4&);
+    void drawText(std::string_view text, const Font& font, const glm::vec2& position, float scale,
+                  const glm::vec4& color);
     void drawText(std::string_view text, const Font& font, const glm::vec2& position, float scale,
+                  const TextStyle& style);
+    void drawText(const TextLayout& layout, const glm::vec2& position, float scale,
                   const glm::vec4& color);
+    void drawText(const TextLayout& layout, const glm::vec2& position, float scale,
+                  const TextStyle& style);
+
+    // Formats into a renderer-owned buffer, so per-frame HUD text does not allocate
+    template <typename... Args>
+    void drawTextFormat(const Font& font, const glm::vec2& position, float scale,
+                        const TextStyle& style, std::format_string<Args...> fmt, Args&&... args) {
+        m_text_format_buffer.clear();
+        std::format_to(std::back_inserter(m_text_format_buffer), fmt, std::forward<Args>(args)...);
+        drawText(m_text_format_buffer, font, position, scale, style);
+    }
+
+    template <typename... Args>
+    void drawTextFormat(const Font& font, const glm::vec2& position, float scale,
+                        const glm::vec4& color, std::format_string<Args...> fmt, Args&&... args) {
+        drawTextFormat(font, position, scale, TextStyle{.color = color}, fmt,
+                       std::forward<Args>(args)...);
+    }
     void drawCircle(const glm::mat4& transform, const glm::vec4& color);
 
+    // Swaps in shaders edited on disk. Only builds with MAMBA_SHADER_HOT_RELOAD watch the
+    // files, elsewhere this does nothing. Call at the start of a frame.
+    void reloadShaders();
+
+    const RendererStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
   private:
+    void applyShaderUniforms();
     int insertTexture(const Texture& texture);
+    void submitQuad(const glm::mat4& transform, const Texture& texture, const glm::vec2& uv_min,
+                    const glm::vec2& uv_max, const glm::vec4& tint_color,
+                    const Material* material = nullptr);
+    void useFont(const Font& font);
+    void pushGlyph(const glm::vec4& plane, const glm::vec4& uv, const TextStyle& style);
     void startBatch();
     void nextBatch();
     void flush();
 
   private:
+    // First so the samplers outlive every texture the renderer holds
+    SamplerCache m_sampler_cache;
     std::optional<mamba::Renderer::Texture> m_white_texture;
     std::optional<mamba::Renderer::UniformBuffer<CameraData>> m_ubo;
 
@@ -76,7 +168,9 @@ class Renderer2D {
     std::optional<mamba::Renderer::VertexBuffer<QuadVertex>> m_vbo;
     mamba::Renderer::VertexArray m_vao;
     std::vector<QuadVertex> m_quad_vertices;
+    std::vector<QuadRun> m_quad_runs;
     std::array<GLuint, 16> m_texture_slots;
+    std::array<GLuint, 16> m_sampler_slots;
     size_t m_texture_idx;
 
     // Text rendering
@@ -84,13 +178,27 @@ class Renderer2D {
     std::optional<mamba::Renderer::VertexBuffer<TextVertex>> m_text_vbo;
     mamba::Renderer::VertexArray m_text_vao;
     std::vector<TextVertex> m_text_vertices;
-    GLuint m_text_texture_slot;
+    GLuint m_text_texture_slot{0};
+    GLuint m_text_sampler_slot{0};
+    float m_text_pixel_range{0.0f};
+    bool m_text_distance_in_alpha{false};
+    GLint m_text_pixel_range_location{-1};
+    GLint m_text_distance_in_alpha_location{-1};
+    std::string m_text_format_buffer;
 
     // Circle rendering
     std::optional<mamba::Renderer::Shader> m_circle_shader;
     std::optional<mamba::Renderer::VertexBuffer<CircleVertex>> m_circle_vbo;
     mamba::Renderer::VertexArray m_circle_vao;
     std::vector<CircleVertex> m_circle_vertices;
+
+    RendererStats m_stats{};
+
+#ifdef MAMBA_SHADER_HOT_RELOAD
+    ShaderLibrary m_shader_library;
+    // Indexed by ShaderLibrary::Id
+    std::vector<std::optional<Shader>*> m_watched_shaders;
+#endif
 };
 
 } // namespace Renderer
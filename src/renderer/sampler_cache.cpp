@@ -0,0 +1,53 @@
+#include "sampler_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace mamba::Renderer {
+
+namespace {
+SamplerCache* current_cache = nullptr;
+} // namespace
+
+SamplerCache::SamplerCache() : m_previous(std::exchange(current_cache, this)) {
+    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &m_max_anisotropy);
+}
+
+SamplerCache::~SamplerCache() {
+    for (const auto& entry : m_samplers)
+        glDeleteSamplers(1, &entry.sampler);
+    if (current_cache == this)
+        current_cache = m_previous;
+}
+
+SamplerCache* SamplerCache::current() { return current_cache; }
+
+GLuint SamplerCache::get(const TextureSpecification& spec, bool mipmapped) {
+    float anisotropy = std::clamp(spec.anisotropy, 1.0f, m_max_anisotropy);
+
+    for (const auto& entry : m_samplers) {
+        if (entry.filter == spec.filter && entry.wrap == spec.wrap &&
+            entry.anisotropy == anisotropy && entry.mipmapped == mipmapped)
+            return entry.sampler;
+    }
+
+    bool linear = spec.filter == TextureFilter::Linear;
+    GLenum min_filter = mipmapped ? (linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR)
+                                  : (linear ? GL_LINEAR : GL_NEAREST);
+    GLenum wrap = spec.wrap == TextureWrap::Repeat        ? GL_REPEAT
+                  : spec.wrap == TextureWrap::ClampToEdge ? GL_CLAMP_TO_EDGE
+                                                          : GL_MIRRORED_REPEAT;
+
+    GLuint sampler;
+    glCreateSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, min_filter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, linear ? GL_LINEAR : GL_NEAREST);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrap);
+    glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
+
+    m_samplers.push_back({spec.filter, spec.wrap, anisotropy, mipmapped, sampler});
+    return sampler;
+}
+
+} // namespace mamba::Renderer
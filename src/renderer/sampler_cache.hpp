@@ -0,0 +1,42 @@
+#pragma once
+
+#include "renderer/texture.hpp"
+
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+/// Sampler objects of one GL context, one per distinct filter, wrap and anisotropy state and
+/// shared by every texture using it. Renderer2D owns the cache of its context, so the samplers
+/// are deleted while the context is still alive and a later context starts with none.
+class SamplerCache {
+  public:
+    // Needs a current GL context. Textures created from now on take their samplers from here.
+    SamplerCache();
+    ~SamplerCache();
+
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+
+    GLuint get(const TextureSpecification& spec, bool mipmapped);
+
+    // The most recently created cache still alive, null when there is none
+    static SamplerCache* current();
+
+  private:
+    struct Entry {
+        TextureFilter filter;
+        TextureWrap wrap;
+        float anisotropy;
+        bool mipmapped;
+        GLuint sampler;
+    };
+
+    std::vector<Entry> m_samplers;
+    float m_max_anisotropy{1.0f};
+    SamplerCache* m_previous; // Current again once this one is destroyed
+};
+
+} // namespace mamba::Renderer
@@ -1,8 +1,11 @@
 #include "shader.hpp"
 
+#include "renderer/program_cache.hpp"
+
+#include <algorithm>
 #include <fstream>
-#include <iostream>
-#include <optional>
+#include <iterator>
+#include <sstream>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -10,40 +13,110 @@
 #include <glad/glad.h>
 
 namespace {
-std::string readFile(const std::filesystem::path& path) {
+std::expected<std::string, std::string> readFile(const std::filesystem::path& path) {
     std::ifstream file(path);
 
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << path.string() << std::endl;
-        return {};
-    }
+    if (!file.is_open())
+        return std::unexpected("Failed to open file: " + path.string());
 
     std::ostringstream stream;
     stream << file.rdbuf();
     return stream.str();
 }
 
-GLuint compileShader(std::string_view source, GLuint shader_type) {
-
+// Status queries block until the driver is done, so they come after all work is issued
+GLuint issueShader(std::string_view source, GLuint shader_type) {
     GLuint shader = glCreateShader(shader_type);
     const char* source_ptr = source.data();
     GLint source_len = static_cast<GLint>(source.size());
     glShaderSource(shader, 1, &source_ptr, &source_len);
     glCompileShader(shader);
+    return shader;
+}
 
+// Empty when the shader compiled
+std::string shaderError(GLuint shader, std::string_view stage) {
     GLint success = 0;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (success == GL_FALSE) {
-        GLint length = 0;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    if (success == GL_TRUE)
+        return {};
+
+    GLint length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    std::string log(std::max(length, 1), '\0');
+    glGetShaderInfoLog(shader, length, &length, log.data());
+    log.resize(length);
+    return std::string(stage) + " shader: " + log;
+}
+
+std::string programError(GLuint program) {
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_TRUE)
+        return {};
 
-        std::vector<GLchar> log(length);
-        glGetShaderInfoLog(shader, length, &length, log.data());
+    GLint length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::string log(std::max(length, 1), '\0');
+    glGetProgramInfoLog(program, length, &length, log.data());
+    log.resize(length);
+    return "Program link: " + log;
+}
 
-        std::cerr << log.data() << std::endl;
-        glDeleteShader(shader);
+// Every sampler type of GL 4.6 core, images and atomic counters are not samplers
+bool isSampler(GLenum type) {
+    switch (type) {
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+        return true;
+    default:
+        return false;
     }
-    return shader;
+}
+
+std::string resourceName(GLuint program, GLenum interface, GLuint index, GLint length) {
+    std::string name(std::max(length, 1), '\0');
+    glGetProgramResourceName(program, interface, index, length, &length, name.data());
+    name.resize(length);
+    return name;
 }
 } // namespace
 
@@ -51,52 +124,153 @@ namespace mamba {
 
 namespace Renderer {
 
-Shader::Shader(Shader&& other) noexcept : m_program(std::exchange(other.m_program, 0)) {}
+Shader::Shader(GLuint program) : m_program(program) { reflect(); }
+
+Shader::Shader(Shader&& other) noexcept
+    : m_program(std::exchange(other.m_program, 0)), m_uniforms(std::move(other.m_uniforms)),
+      m_uniform_blocks(std::move(other.m_uniform_blocks)) {}
 
 Shader& Shader::operator=(Shader&& other) noexcept {
     std::swap(m_program, other.m_program);
+    std::swap(m_uniforms, other.m_uniforms);
+    std::swap(m_uniform_blocks, other.m_uniform_blocks);
     return *this;
 }
 
 void Shader::bind() { glUseProgram(m_program); }
 void Shader::unbind() { glUseProgram(0); }
 
-std::optional<Shader> Shader::create(const std::filesystem::path& vertex_path,
-                                     const std::filesystem::path& fragment_path) {
-    std::string vertex_shader_src = readFile(vertex_path);
-    std::string fragment_shader_src = readFile(fragment_path);
+void Shader::reflect() {
+    GLint count = 0;
+    glGetProgramInterfaceiv(m_program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    for (GLint i = 0; i < count; ++i) {
+        constexpr GLenum properties[] = {GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE,
+                                         GL_BLOCK_INDEX};
+        GLint values[std::size(properties)];
+        glGetProgramResourceiv(m_program, GL_UNIFORM, i, std::size(properties), properties,
+                               std::size(values), nullptr, values);
+
+        // Members of uniform blocks have no location of their own
+        if (values[4] != -1)
+            continue;
+
+        auto name = resourceName(m_program, GL_UNIFORM, i, values[0]);
+        UniformInfo info{
+            .location = values[2],
+            .type = static_cast<GLenum>(values[1]),
+            .array_size = values[3],
+            .sampler = isSampler(static_cast<GLenum>(values[1])),
+        };
+        // Arrays are reported as "name[0]", make them reachable by their plain name too
+        if (name.ends_with("[0]"))
+            m_uniforms.emplace(name.substr(0, name.size() - 3), info);
+        m_uniforms.emplace(std::move(name), info);
+    }
+
+    glGetProgramInterfaceiv(m_program, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &count);
+    for (GLint i = 0; i < count; ++i) {
+        constexpr GLenum properties[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        GLint values[std::size(properties)];
+        glGetProgramResourceiv(m_program, GL_UNIFORM_BLOCK, i, std::size(properties), properties,
+                               std::size(values), nullptr, values);
+
+        m_uniform_blocks.emplace(resourceName(m_program, GL_UNIFORM_BLOCK, i, values[0]),
+                                 UniformBlockInfo{static_cast<GLuint>(i), values[1], values[2]});
+    }
+}
 
-    return createFromSource(vertex_shader_src.c_str(), fragment_shader_src.c_str());
+GLint Shader::getUniformLocation(std::string_view name) const {
+    const auto* info = findUniform(name);
+    return info ? info->location : -1;
 }
 
-std::optional<Shader> Shader::createFromSource(std::string_view vertex_source,
-                                               std::string_view fragment_source) {
-    GLuint vertex_shader = compileShader(vertex_source, GL_VERTEX_SHADER);
-    GLuint fragment_shader = compileShader(fragment_source, GL_FRAGMENT_SHADER);
+const UniformInfo* Shader::findUniform(std::string_view name) const {
+    auto found = m_uniforms.find(name);
+    return found != m_uniforms.end() ? &found->second : nullptr;
+}
 
-    // Program linking
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex_shader);
-    glAttachShader(program, fragment_shader);
-    glLinkProgram(program);
+const UniformBlockInfo* Shader::findUniformBlock(std::string_view name) const {
+    auto found = m_uniform_blocks.find(name);
+    return found != m_uniform_blocks.end() ? &found->second : nullptr;
+}
 
-    GLint success = 0;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (success == GL_FALSE) {
-        GLint length = 0;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+ShaderResult Shader::create(const std::filesystem::path& vertex_path,
+                            const std::filesystem::path& fragment_path) {
+    auto vertex_source = readFile(vertex_path);
+    if (!vertex_source)
+        return std::unexpected(vertex_source.error());
+    auto fragment_source = readFile(fragment_path);
+    if (!fragment_source)
+        return std::unexpected(fragment_source.error());
+
+    return createFromSource(*vertex_source, *fragment_source);
+}
+
+ShaderResult Shader::createFromSource(std::string_view vertex_source,
+                                      std::string_view fragment_source) {
+    ShaderSource source{vertex_source, fragment_source};
+    return std::move(createFromSources(std::span(&source, 1)).front());
+}
+
+std::vector<ShaderResult> Shader::createFromSources(std::span<const ShaderSource> sources) {
+    ProgramCache cache;
+
+    struct Pending {
+        uint64_t key;
+        GLuint program;
+        GLuint vertex_shader{0};
+        GLuint fragment_shader{0};
+    };
+    std::vector<Pending> pending;
+    pending.reserve(sources.size());
 
-        std::vector<GLchar> log(length);
-        glGetProgramInfoLog(program, length, &length, &log[0]);
+    for (const auto& source : sources) {
+        uint64_t key = cache.key(source.vertex, source.fragment);
+        GLuint program = cache.load(key);
+        if (program) {
+            pending.push_back({key, program});
+            continue;
+        }
 
-        std::cerr << log.data() << std::endl;
+        GLuint vertex_shader = issueShader(source.vertex, GL_VERTEX_SHADER);
+        GLuint fragment_shader = issueShader(source.fragment, GL_FRAGMENT_SHADER);
 
-        glDeleteProgram(program);
+        program = glCreateProgram();
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(program, vertex_shader);
+        glAttachShader(program, fragment_shader);
+        glLinkProgram(program);
+        pending.push_back({key, program, vertex_shader, fragment_shader});
     }
 
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-    return Shader(program);
+    std::vector<ShaderResult> shaders;
+    shaders.reserve(pending.size());
+    for (auto& item : pending) {
+        // Loaded from the cache
+        if (!item.vertex_shader) {
+            shaders.push_back(Shader(item.program));
+            continue;
+        }
+
+        // Both stages are checked so one failure does not hide the other
+        std::string error = shaderError(item.vertex_shader, "Vertex");
+        error += shaderError(item.fragment_shader, "Fragment");
+        if (error.empty())
+            error = programError(item.program);
+
+        glDeleteShader(item.vertex_shader);
+        glDeleteShader(item.fragment_shader);
+
+        if (!error.empty()) {
+            glDeleteProgram(item.program);
+            shaders.push_back(std::unexpected(std::move(error)));
+            continue;
+        }
+
+        cache.store(item.key, item.program);
+        shaders.push_back(Shader(item.program));
+    }
+    return shaders;
 }
 
 } // namespace Renderer
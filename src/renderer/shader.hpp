@@ -1,14 +1,41 @@
 #pragma once
 
+#include <expected>
 #include <filesystem>
+#include <functional>
 #include <glad/glad.h>
-#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace mamba {
 
 namespace Renderer {
 
+struct ShaderSource {
+    std::string_view vertex;
+    std::string_view fragment;
+};
+
+struct UniformInfo {
+    GLint location;
+    GLenum type;
+    GLint array_size;
+    bool sampler;
+};
+
+struct UniformBlockInfo {
+    GLuint index;
+    GLint binding;
+    GLint size; // Bytes
+};
+
+struct Shader;
+// On failure, the compile or link log
+using ShaderResult = std::expected<Shader, std::string>;
+
 struct Shader {
     ~Shader() { glDeleteProgram(m_program); }
     Shader(const Shader&) = delete;
@@ -19,17 +46,44 @@ struct Shader {
     void bind();
     void unbind();
 
-    static std::optional<Shader> create(const std::filesystem::path& vertex_path,
-                                        const std::filesystem::path& fragment_path);
+    GLuint handle() const { return m_program; }
 
-    static std::optional<Shader> createFromSource(std::string_view vertex_source,
-                                                  std::string_view fragment_source);
+    // Active uniforms and blocks are reflected once after linking. Lookups take a string_view
+    // and do not allocate, but are still hash lookups: resolve locations once, not per draw.
+    GLint getUniformLocation(std::string_view name) const;
+    const UniformInfo* findUniform(std::string_view name) const;
+    const UniformBlockInfo* findUniformBlock(std::string_view name) const;
+
+    static ShaderResult create(const std::filesystem::path& vertex_path,
+                               const std::filesystem::path& fragment_path);
+
+    static ShaderResult createFromSource(std::string_view vertex_source,
+                                         std::string_view fragment_source);
+
+    // Loads each program from the program binary cache when possible and compiles the rest.
+    // Every compile and link is issued before any status is read, so drivers that compile on
+    // background threads work on all programs at once. Results match the order of `sources`.
+    static std::vector<ShaderResult> createFromSources(std::span<const ShaderSource> sources);
 
   private:
-    Shader(GLuint program) : m_program(program) {};
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    template <typename T>
+    using NameMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+    explicit Shader(GLuint program);
+
+    void reflect();
 
   private:
     GLuint m_program{0};
+    NameMap<UniformInfo> m_uniforms;
+    NameMap<UniformBlockInfo> m_uniform_blocks;
 };
 
 } // namespace Renderer
@@ -0,0 +1,135 @@
+#include "shader_library.hpp"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace mamba::Renderer {
+
+namespace {
+
+std::filesystem::path normalize(const std::filesystem::path& path) {
+    std::error_code error;
+    auto canonical = std::filesystem::weakly_canonical(path, error);
+    return error ? path.lexically_normal() : canonical;
+}
+
+} // namespace
+
+#ifdef __linux__
+
+ShaderLibrary::ShaderLibrary() {
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0)
+        std::cerr << "Shader hot reload unavailable: inotify_init1 failed\n";
+}
+
+ShaderLibrary::~ShaderLibrary() {
+    if (m_inotify >= 0)
+        close(m_inotify);
+}
+
+auto ShaderLibrary::watch(const std::filesystem::path& vertex_path,
+                          const std::filesystem::path& fragment_path) -> Id {
+    m_programs.push_back({normalize(vertex_path), normalize(fragment_path)});
+    const auto& program = m_programs.back();
+
+    // Directories rather than files: editors that save by renaming a temporary file over the
+    // original would otherwise silently end the watch
+    if (m_inotify >= 0) {
+        for (const auto& path : {program.vertex_path, program.fragment_path}) {
+            auto directory = path.parent_path();
+            int watch = inotify_add_watch(m_inotify, directory.c_str(),
+                                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (watch < 0)
+                std::cerr << "Cannot watch shader directory: " << directory.string() << "\n";
+            else
+                m_watched_directories[watch] = directory;
+        }
+    }
+    return static_cast<Id>(m_programs.size() - 1);
+}
+
+void ShaderLibrary::pollChanges() {
+    if (m_inotify >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(cursor);
+                auto directory = m_watched_directories.find(event->wd);
+                if (event->len > 0 && directory != m_watched_directories.end())
+                    markChanged(directory->second / event->name);
+                cursor += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+#else
+
+ShaderLibrary::ShaderLibrary() = default;
+ShaderLibrary::~ShaderLibrary() = default;
+
+auto ShaderLibrary::watch(const std::filesystem::path& vertex_path,
+                          const std::filesystem::path& fragment_path) -> Id {
+    m_programs.push_back({normalize(vertex_path), normalize(fragment_path)});
+    for (const auto& path : {m_programs.back().vertex_path, m_programs.back().fragment_path}) {
+        std::error_code error;
+        m_write_times[path.string()] = std::filesystem::last_write_time(path, error);
+    }
+    return static_cast<Id>(m_programs.size() - 1);
+}
+
+void ShaderLibrary::pollChanges() {
+    // A handful of stat calls, but there is no need to make them every frame
+    auto now = std::chrono::steady_clock::now();
+    if (now >= m_next_poll) {
+        m_next_poll = now + std::chrono::milliseconds(250);
+        for (auto& [path, write_time] : m_write_times) {
+            std::error_code error;
+            auto current = std::filesystem::last_write_time(path, error);
+            if (!error && current != write_time) {
+                write_time = current;
+                markChanged(path);
+            }
+        }
+    }
+}
+
+#endif
+
+auto ShaderLibrary::update() -> std::vector<Reloaded> {
+    pollChanges();
+
+    std::vector<Reloaded> reloaded;
+    for (size_t id = 0; id < m_programs.size(); ++id) {
+        auto& program = m_programs[id];
+        if (!program.changed)
+            continue;
+        program.changed = false;
+
+        auto shader = Shader::create(program.vertex_path, program.fragment_path);
+        if (!shader) {
+            std::cerr << "Shader reload failed, keeping the previous program: "
+                      << program.vertex_path.string() << ", " << program.fragment_path.string()
+                      << "\n"
+                      << shader.error() << "\n";
+            continue;
+        }
+        reloaded.push_back({static_cast<Id>(id), std::move(*shader)});
+    }
+    return reloaded;
+}
+
+void ShaderLibrary::markChanged(const std::filesystem::path& path) {
+    for (auto& program : m_programs) {
+        if (program.vertex_path == path || program.fragment_path == path)
+            program.changed = true;
+    }
+}
+
+} // namespace mamba::Renderer
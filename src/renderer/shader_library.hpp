@@ -0,0 +1,60 @@
+#pragma once
+
+#include "renderer/shader.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mamba::Renderer {
+
+/// Development helper that recompiles programs whose source files change on disk. Changes are
+/// picked up through inotify on Linux and by polling modification times elsewhere.
+class ShaderLibrary {
+  public:
+    using Id = uint32_t;
+
+    struct Reloaded {
+        Id id;
+        Shader shader;
+    };
+
+    ShaderLibrary();
+    ~ShaderLibrary();
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    // Ids are handed out in order, starting at 0. Nothing is compiled until a file changes.
+    Id watch(const std::filesystem::path& vertex_path, const std::filesystem::path& fragment_path);
+
+    // Recompiles every program with a changed file. Programs that fail to compile are left out
+    // and their errors printed, so the caller keeps drawing with the previous version.
+    // Call on the GL thread, between frames.
+    std::vector<Reloaded> update();
+
+  private:
+    struct Program {
+        std::filesystem::path vertex_path;
+        std::filesystem::path fragment_path;
+        bool changed{false};
+    };
+
+    void pollChanges();
+    void markChanged(const std::filesystem::path& path);
+
+    std::vector<Program> m_programs;
+
+#ifdef __linux__
+    int m_inotify{-1};
+    std::unordered_map<int, std::filesystem::path> m_watched_directories;
+#else
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_write_times;
+    std::chrono::steady_clock::time_point m_next_poll;
+#endif
+};
+
+} // namespace mamba::Renderer
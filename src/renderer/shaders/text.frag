@@ -2,22 +2,76 @@
 
 in vec4 vColor;
 in vec2 vTexCoord;
+in flat vec4 vOutlineColor;
+in flat vec4 vShadowColor;
+in flat vec4 vGlowColor;
+in flat vec2 vShadowOffset;
+in flat vec3 vEffectParams; // outline width, shadow softness, glow width
 
 out vec4 FragColor;
 
 layout(location = 1) uniform sampler2D uTexture;
+layout(location = 2) uniform float uPixelRange;
+// False for MSDF atlases, which have no true distance channel
+layout(location = 3) uniform bool uDistanceInAlpha;
 
 float median(float r, float g, float b) {
     return max(min(r, g), min(max(r, g), b));
 }
 
+// Number of screen pixels covered by the atlas distance range at this fragment
+float screenPxRange() {
+    vec2 unitRange = vec2(uPixelRange) / vec2(textureSize(uTexture, 0));
+    vec2 screenTexSize = vec2(1.0) / fwidth(vTexCoord);
+    return max(0.5 * dot(unitRange, screenTexSize), 1.0);
+}
+
+// Straight-alpha "over" operator
+vec4 over(vec4 top, vec4 bottom) {
+    float alpha = top.a + bottom.a * (1.0 - top.a);
+    vec3 color = top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a);
+    return vec4(color / max(alpha, 1e-5), alpha);
+}
+
 void main() {
-    vec4 msdf = texture(uTexture, vTexCoord);
-    float sd = median(msdf.r, msdf.g, msdf.b);
+    vec4 mtsdf = texture(uTexture, vTexCoord);
+    float sd = median(mtsdf.r, mtsdf.g, mtsdf.b);
+    float trueSd = uDistanceInAlpha ? mtsdf.a : sd;
+    float pxRange = screenPxRange();
+
+    float outlineWidth = vEffectParams.x;
+    float shadowSoftness = vEffectParams.y;
+    float glowWidth = vEffectParams.z;
+
+    vec4 result = vec4(0.0);
+
+    // Glow and shadow use the true distance in the alpha channel, which stays smooth far from
+    // the glyph where the multi-channel median produces artifacts
+    if (glowWidth > 0.0 && vGlowColor.a > 0.0) {
+        float glow = smoothstep(0.5 - 0.5 * glowWidth, 0.5, trueSd);
+        result = over(vec4(vGlowColor.rgb, vGlowColor.a * glow), result);
+    }
+
+    if (vShadowColor.a > 0.0) {
+        vec2 offset = vShadowOffset / vec2(textureSize(uTexture, 0));
+        vec4 shadowSample = texture(uTexture, vTexCoord - offset);
+        float shadowSd = uDistanceInAlpha
+                             ? shadowSample.a
+                             : median(shadowSample.r, shadowSample.g, shadowSample.b);
+        float softness = max(0.5 * shadowSoftness, 0.5 / pxRange);
+        float shadow = smoothstep(0.5 - softness, 0.5 + softness, shadowSd);
+        result = over(vec4(vShadowColor.rgb, vShadowColor.a * shadow), result);
+    }
+
+    if (outlineWidth > 0.0 && vOutlineColor.a > 0.0) {
+        float outline = clamp(pxRange * (sd - 0.5 + 0.5 * outlineWidth) + 0.5, 0.0, 1.0);
+        result = over(vec4(vOutlineColor.rgb, vOutlineColor.a * outline), result);
+    }
 
     // Screen-space derivative for anti-aliasing
-    float screenPxDistance = 2.0 * (sd - 0.5);
+    float screenPxDistance = pxRange * (sd - 0.5);
     float opacity = clamp(screenPxDistance + 0.5, 0.0, 1.0);
+    result = over(vec4(vColor.rgb, vColor.a * opacity), result);
 
-    FragColor = vec4(vColor.rgb, vColor.a * opacity);
+    FragColor = result;
 }
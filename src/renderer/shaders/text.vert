@@ -3,9 +3,19 @@
 layout(location = 0) in vec4 aPosition;
 layout(location = 1) in vec2 aTexCoord;
 layout(location = 2) in vec4 aColor;
+layout(location = 3) in vec4 aOutlineColor;
+layout(location = 4) in vec4 aShadowColor;
+layout(location = 5) in vec4 aGlowColor;
+layout(location = 6) in vec2 aShadowOffset;
+layout(location = 7) in vec3 aEffectParams;
 
 out vec4 vColor;
 out vec2 vTexCoord;
+out flat vec4 vOutlineColor;
+out flat vec4 vShadowColor;
+out flat vec4 vGlowColor;
+out flat vec2 vShadowOffset;
+out flat vec3 vEffectParams;
 
 layout(std140, binding=0) uniform Camera {
     mat4 uViewProjection;
@@ -15,4 +25,9 @@ void main() {
     gl_Position = uViewProjection * aPosition;
     vColor = aColor;
     vTexCoord = aTexCoord;
+    vOutlineColor = aOutlineColor;
+    vShadowColor = aShadowColor;
+    vGlowColor = aGlowColor;
+    vShadowOffset = aShadowOffset;
+    vEffectParams = aEffectParams;
 }
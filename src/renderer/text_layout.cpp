@@ -0,0 +1,58 @@
+#include "text_layout.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace mamba::Renderer {
+
+void TextLayout::setText(std::string_view text, const Font& font) {
+    // Everything up to the first differing byte is still valid
+    size_t prefix = 0;
+    if (m_font == &font) {
+        auto [old_it, new_it] = std::ranges::mismatch(m_text, text);
+        prefix = static_cast<size_t>(std::distance(m_text.begin(), old_it));
+    }
+
+    // Keep the code points that end within the prefix
+    auto first_changed = std::ranges::lower_bound(m_cursors, prefix, {}, &Cursor::offset);
+    size_t keep = static_cast<size_t>(std::distance(m_cursors.begin(), first_changed));
+    size_t kept_end = keep < m_cursors.size() ? m_cursors[keep].offset : m_text.size();
+    if (keep > 0 && kept_end > prefix)
+        --keep;
+
+    glm::vec2 pen = m_end_pen;
+    size_t index = m_text.size();
+    if (keep < m_cursors.size()) {
+        pen = m_cursors[keep].pen;
+        index = m_cursors[keep].offset;
+        m_quads.resize(m_cursors[keep].quad_index);
+        m_cursors.resize(keep);
+    }
+
+    m_font = &font;
+    m_text.assign(text);
+
+    while (index < text.size()) {
+        m_cursors.push_back(
+            {pen, static_cast<uint32_t>(m_quads.size()), static_cast<uint32_t>(index)});
+
+        uint32_t codepoint = nextCodepoint(text, index);
+        if (codepoint == '\n') {
+            pen.x = 0.0f;
+            pen.y -= font.getLineHeight();
+            continue;
+        }
+
+        const Font::Glyph* glyph = font.getGlyph(codepoint);
+        if (!glyph)
+            continue;
+
+        glm::vec4 origin{pen, pen};
+        m_quads.push_back({.plane = origin + glyph->plane, .uv = glyph->uv});
+        pen.x += glyph->advance;
+    }
+
+    m_end_pen = pen;
+}
+
+} // namespace mamba::Renderer
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "renderer/font.hpp"
+
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mamba::Renderer {
+
+/// Glyph quads of a string laid out once and drawn many times.
+/// Updating the text only lays out the part after the prefix shared with the previous text, so
+/// counters and timers re-layout just their changing digits. Buffers keep their capacity, so
+/// steady-state updates do not allocate.
+class TextLayout {
+  public:
+    struct GlyphQuad {
+        glm::vec4 plane; // left, bottom, right, top in em units relative to the origin
+        glm::vec4 uv;    // left, bottom, right, top normalized atlas coordinates
+    };
+
+    void setText(std::string_view text, const Font& font);
+
+    template <typename... Args>
+    void format(const Font& font, std::format_string<Args...> fmt, Args&&... args) {
+        m_format_buffer.clear();
+        std::format_to(std::back_inserter(m_format_buffer), fmt, std::forward<Args>(args)...);
+        setText(m_format_buffer, font);
+    }
+
+    const Font* getFont() const { return m_font; }
+    std::string_view getText() const { return m_text; }
+    std::span<const GlyphQuad> getQuads() const { return m_quads; }
+
+  private:
+    // Layout state before a code point
+    struct Cursor {
+        glm::vec2 pen;
+        uint32_t quad_index;
+        uint32_t offset; // Byte offset of the code point in m_text
+    };
+
+    const Font* m_font = nullptr;
+    std::string m_text;
+    std::string m_format_buffer;
+    std::vector<Cursor> m_cursors;
+    std::vector<GlyphQuad> m_quads;
+    glm::vec2 m_end_pen{0.0f};
+};
+
+} // namespace mamba::Renderer
@@ -1,101 +1,248 @@
 #include "texture.hpp"
 
+#include "renderer/ktx2.hpp"
+#include "renderer/sampler_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "stb_image.h"
 
 namespace mamba::Renderer {
 
-auto Texture::create(const std::filesystem::path& path) -> std::optional<Texture> {
-    stbi_set_flip_vertically_on_load(1);
+namespace {
+
+// Bytes per 4x4 block for compressed formats, per texel otherwise
+struct FormatSize {
+    size_t bytes;
+    bool compressed;
+};
+
+FormatSize formatSize(GLenum format) {
+    switch (format) {
+    case GL_R8:
+        return {1, false};
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        return {8, true};
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        return {16, true};
+    default:
+        // RGB8 is padded to four bytes per texel by every driver we know of
+        return {4, false};
+    }
+}
 
-    int width, height, channels;
-    std::string filepath = path.string();
-    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
+size_t storageSize(int width, int height, int levels, GLenum format) {
+    auto [bytes, compressed] = formatSize(format);
+    size_t size = 0;
+    for (int level = 0; level < levels; ++level) {
+        size_t level_width = std::max(width >> level, 1);
+        size_t level_height = std::max(height >> level, 1);
+        if (compressed) {
+            level_width = (level_width + 3) / 4;
+            level_height = (level_height + 3) / 4;
+        }
+        size += level_width * level_height * bytes;
+    }
+    return size;
+}
 
-    if (!data) {
-        std::cerr << "Failed to load texture: " << filepath << "\n";
+} // namespace
+
+int mipLevelCount(int width, int height) {
+    return std::bit_width(static_cast<unsigned>(std::max({width, height, 1})));
+}
+
+auto Texture::create(const std::filesystem::path& path, const TextureSpecification& spec)
+    -> std::optional<Texture> {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open texture: " << path.string() << "\n";
         return std::nullopt;
     }
+    std::vector<uint8_t> data(std::filesystem::file_size(path));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
 
-    GLenum format = channels == 4 ? GL_RGBA : channels == 3 ? GL_RGB : channels == 1 ? GL_RED : 0;
-    GLenum internal_format = format == GL_RGBA ? GL_RGBA8 : GL_RGB8;
+    auto texture = createFromMemory(data, spec);
+    if (!texture)
+        std::cerr << "Failed to load texture: " << path.string() << "\n";
+    return texture;
+}
 
-    GLuint handle;
-    glCreateTextures(GL_TEXTURE_2D, 1, &handle);
+auto Texture::createFromMemory(std::span<const uint8_t> encoded, const TextureSpecification& spec)
+    -> std::optional<Texture> {
+    if (encoded.size() >= Ktx2::IDENTIFIER.size() &&
+        std::equal(Ktx2::IDENTIFIER.begin(), Ktx2::IDENTIFIER.end(), encoded.begin()))
+        return createKtx2(encoded, spec);
 
-    glTextureStorage2D(handle, 1, internal_format, width, height);
-    glTextureSubImage2D(handle, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    stbi_set_flip_vertically_on_load(1);
 
-    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    int width, height, channels;
+    auto size = static_cast<int>(encoded.size());
+    if (!stbi_info_from_memory(encoded.data(), size, &width, &height, &channels)) {
+        std::cerr << "Unsupported image: " << stbi_failure_reason() << "\n";
+        return std::nullopt;
+    }
 
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    // Grey and alpha images are expanded, there is no two channel upload path
+    int desired_channels = channels == 2 ? 4 : 0;
+    unsigned char* data = stbi_load_from_memory(encoded.data(), size, &width, &height, &channels,
+                                                desired_channels);
 
-    glGenerateTextureMipmap(handle);
+    if (!data) {
+        std::cerr << "Failed to decode image: " << stbi_failure_reason() << "\n";
+        return std::nullopt;
+    }
 
+    auto texture =
+        create(data, width, height, desired_channels ? desired_channels : channels, spec);
     stbi_image_free(data);
-
-    return Texture(handle, width, height);
+    return texture;
 }
 
-auto Texture::create(const uint8_t* data, int width, int height, int channels) -> Texture {
+auto Texture::create(const uint8_t* data, int width, int height, int channels,
+                     const TextureSpecification& spec) -> Texture {
 
     GLuint handle;
     glCreateTextures(GL_TEXTURE_2D, 1, &handle);
 
-    GLenum internal_format = channels == 4 ? GL_RGBA8 : GL_RGB8;
-    GLenum format = channels == 4 ? GL_RGBA : GL_RGB;
+    GLenum internal_format = channels == 4 ? (spec.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8)
+                             : channels == 1 ? GL_R8
+                                             : (spec.srgb ? GL_SRGB8 : GL_RGB8);
+    GLenum format = channels == 4 ? GL_RGBA : channels == 1 ? GL_RED : GL_RGB;
+    int levels = spec.generate_mips ? mipLevelCount(width, height) : 1;
 
-    glTextureStorage2D(handle, 1, internal_format, width, height);
+    glTextureStorage2D(handle, levels, internal_format, width, height);
+    // Rows of 1 and 3 channel data are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, channels == 4 ? 4 : 1);
     glTextureSubImage2D(handle, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    if (levels > 1)
+        glGenerateTextureMipmap(handle);
 
-    glGenerateTextureMipmap(handle);
-    return Texture(handle, width, height);
+    return Texture(handle, width, height, levels, internal_format, getSampler(spec, levels > 1));
 }
 
-auto Texture::createWhite() -> Texture {
+auto Texture::createKtx2(std::span<const uint8_t> data, const TextureSpecification& spec)
+    -> std::optional<Texture> {
+    using namespace Ktx2;
+
+    if (data.size() < LEVEL_INDEX_OFFSET ||
+        !std::equal(IDENTIFIER.begin(), IDENTIFIER.end(), data.begin())) {
+        std::cerr << "Not a KTX2 file\n";
+        return std::nullopt;
+    }
+
+    Header header;
+    std::memcpy(&header, data.data() + IDENTIFIER.size(), sizeof(header));
+
+    auto format = findFormat(header.vk_format);
+    if (!format) {
+        std::cerr << "Unsupported KTX2 format: " << header.vk_format << "\n";
+        return std::nullopt;
+    }
+    if (header.pixel_depth > 1 || header.layer_count > 1 || header.face_count != 1 ||
+        header.supercompression_scheme != 0) {
+        std::cerr << "Only plain 2D KTX2 textures without supercompression are supported\n";
+        return std::nullopt;
+    }
+
+    // A level count of 0 asks for generated mips, which compressed formats cannot have
+    uint32_t levels = std::max(header.level_count, 1u);
+    int width = static_cast<int>(header.pixel_width);
+    int height = static_cast<int>(header.pixel_height);
+    if (width <= 0 || height <= 0 || levels > static_cast<uint32_t>(mipLevelCount(width, height)) ||
+        data.size() < LEVEL_INDEX_OFFSET + levels * sizeof(LevelIndex)) {
+        std::cerr << "Corrupt KTX2 header\n";
+        return std::nullopt;
+    }
+
+    std::vector<LevelIndex> level_index(levels);
+    std::memcpy(level_index.data(), data.data() + LEVEL_INDEX_OFFSET,
+                levels * sizeof(LevelIndex));
+
+    // Every level has to hold exactly its blocks, the upload never reads past them
+    std::vector<size_t> level_sizes(levels);
+    for (uint32_t level = 0; level < levels; ++level) {
+        size_t blocks_x = (std::max(width >> level, 1) + 3) / 4;
+        size_t blocks_y = (std::max(height >> level, 1) + 3) / 4;
+        level_sizes[level] = blocks_x * blocks_y * format->block_size;
+        const auto& index = level_index[level];
+        if (index.byte_length != level_sizes[level] || index.byte_offset > data.size() ||
+            index.byte_length > data.size() - index.byte_offset) {
+            std::cerr << "Corrupt KTX2 level " << level << "\n";
+            return std::nullopt;
+        }
+    }
+
     GLuint handle;
     glCreateTextures(GL_TEXTURE_2D, 1, &handle);
+    glTextureStorage2D(handle, static_cast<GLsizei>(levels), format->gl_format, width, height);
 
-    uint32_t height = 1;
-    uint32_t width = 1;
-    uint32_t data = 0xFFFFFFFF;
-
-    glTextureStorage2D(handle, 1, GL_RGBA8, width, height);
-    glTextureSubImage2D(handle, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &data);
+    for (uint32_t level = 0; level < levels; ++level) {
+        glCompressedTextureSubImage2D(handle, static_cast<GLint>(level), 0, 0,
+                                      std::max(width >> level, 1), std::max(height >> level, 1),
+                                      format->gl_format, static_cast<GLsizei>(level_sizes[level]),
+                                      data.data() + level_index[level].byte_offset);
+    }
 
-    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return Texture(handle, width, height, static_cast<int>(levels), format->gl_format,
+                   getSampler(spec, levels > 1));
+}
 
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_REPEAT);
+auto Texture::createWhite() -> Texture {
+    uint32_t data = 0xFFFFFFFF;
+    return create(reinterpret_cast<const uint8_t*>(&data), 1, 1, 4, {.generate_mips = false});
+}
 
-    glGenerateTextureMipmap(handle);
-    return Texture(handle, width, height);
+GLuint Texture::getSampler(const TextureSpecification& spec, bool mipmapped) {
+    auto* cache = SamplerCache::current();
+    if (!cache) {
+        // Sampler 0 leaves the texture's own default filtering in place
+        std::cerr << "Textures created without a Renderer2D use default sampling\n";
+        return 0;
+    }
+    return cache->get(spec, mipmapped);
 }
 
-Texture::Texture(GLuint handle, int width, int height)
-    : m_handle(handle), m_width(width), m_height(height) {}
+Texture::Texture(GLuint handle, int width, int height, int levels, GLenum format, GLuint sampler)
+    : m_handle(handle), m_width(width), m_height(height), m_levels(levels), m_format(format),
+      m_sampler(sampler), m_memory_size(storageSize(width, height, levels, format)) {}
 
 Texture::~Texture() { glDeleteTextures(1, &m_handle); }
 
 Texture::Texture(Texture&& other) noexcept
     : m_handle(std::exchange(other.m_handle, 0)), m_width(std::exchange(other.m_width, 0)),
-      m_height(std::exchange(other.m_height, 0)) {}
+      m_height(std::exchange(other.m_height, 0)), m_levels(std::exchange(other.m_levels, 0)),
+      m_format(std::exchange(other.m_format, 0)), m_sampler(std::exchange(other.m_sampler, 0)),
+      m_memory_size(std::exchange(other.m_memory_size, 0)) {}
 
 Texture& Texture::operator=(Texture&& other) noexcept {
     std::swap(m_handle, other.m_handle);
     std::swap(m_width, other.m_width);
     std::swap(m_height, other.m_height);
+    std::swap(m_levels, other.m_levels);
+    std::swap(m_format, other.m_format);
+    std::swap(m_sampler, other.m_sampler);
+    std::swap(m_memory_size, other.m_memory_size);
     return *this;
 }
 
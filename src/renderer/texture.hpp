@@ -1,17 +1,46 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
+#include <span>
 
 #include <glad/glad.h>
 
 namespace mamba {
 namespace Renderer {
 
+enum class TextureFilter { Nearest, Linear };
+enum class TextureWrap { Repeat, ClampToEdge, MirroredRepeat };
+
+struct TextureSpecification {
+    // Allocates and generates the full chain down to 1x1, sampled trilinearly
+    bool generate_mips = true;
+    // Stores 3 and 4 channel data as sRGB so sampling returns linear values
+    bool srgb = false;
+    TextureFilter filter = TextureFilter::Linear;
+    TextureWrap wrap = TextureWrap::Repeat;
+    // Clamped to what the driver supports, 1 disables anisotropic filtering
+    float anisotropy = 1.0f;
+};
+
+/// Number of levels in a full mip chain for the given size
+int mipLevelCount(int width, int height);
+
 class Texture {
   public:
-    static auto create(const std::filesystem::path& path) -> std::optional<Texture>;
-    static auto create(const uint8_t* data, int width, int height, int channels = 3) -> Texture;
+    static auto create(const std::filesystem::path& path, const TextureSpecification& spec = {})
+        -> std::optional<Texture>;
+    // Encoded file contents: KTX2 goes through createKtx2, anything else through stb_image
+    static auto createFromMemory(std::span<const uint8_t> encoded,
+                                 const TextureSpecification& spec = {}) -> std::optional<Texture>;
+    // Block-compressed KTX2 image (BC1/BC3/BC7/ETC2) with its stored mip chain, uploaded as is.
+    // Rows are expected bottom first like every other texture, see tools/texcompress.
+    // generate_mips and srgb are ignored, both come from the file.
+    static auto createKtx2(std::span<const uint8_t> data, const TextureSpecification& spec = {})
+        -> std::optional<Texture>;
+    static auto create(const uint8_t* data, int width, int height, int channels = 3,
+                       const TextureSpecification& spec = {}) -> Texture;
     static auto createWhite() -> Texture;
 
     ~Texture();
@@ -24,13 +53,28 @@ class Texture {
     GLuint handle() const { return m_handle; }
     int width() const { return m_width; }
     int height() const { return m_height; }
+    int levels() const { return m_levels; }
+    GLenum format() const { return m_format; }
+    // Shared sampler object holding the filter and wrap state, bind it next to the texture
+    GLuint sampler() const { return m_sampler; }
+    // Estimated VRAM used by every level of the texture, in bytes
+    size_t memorySize() const { return m_memory_size; }
 
   private:
-    Texture(GLuint handle, int width, int height);
+    friend class TextureLoader;
+
+    Texture(GLuint handle, int width, int height, int levels, GLenum format, GLuint sampler);
+
+    // From the SamplerCache of the current Renderer2D, which owns and deletes it
+    static GLuint getSampler(const TextureSpecification& spec, bool mipmapped);
 
     GLuint m_handle{0};
     int m_width{0};
     int m_height{0};
+    int m_levels{0};
+    GLenum m_format{0};
+    GLuint m_sampler{0};
+    size_t m_memory_size{0};
 };
 
 } // namespace Renderer
@@ -0,0 +1,236 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <tuple>
+
+#include "stb_image.h"
+
+namespace mamba::Renderer {
+
+namespace {
+
+// Bottom-left skyline packer: the packed area is described by its top silhouette, and every
+// rectangle goes where it ends up lowest
+class SkylinePacker {
+  public:
+    SkylinePacker(int width, int height) : m_width(width), m_height(height) {
+        m_skyline.push_back({0, 0, width});
+    }
+
+    std::optional<glm::ivec2> insert(int width, int height) {
+        int best_y = INT_MAX;
+        int best_width = INT_MAX;
+        size_t best_index = m_skyline.size();
+
+        for (size_t i = 0; i < m_skyline.size(); ++i) {
+            auto y = fit(i, width, height);
+            if (!y)
+                continue;
+            if (*y < best_y || (*y == best_y && m_skyline[i].width < best_width)) {
+                best_y = *y;
+                best_width = m_skyline[i].width;
+                best_index = i;
+            }
+        }
+
+        if (best_index == m_skyline.size())
+            return std::nullopt;
+
+        glm::ivec2 position{m_skyline[best_index].x, best_y};
+        addLevel(best_index, position, width, height);
+        return position;
+    }
+
+  private:
+    struct Node {
+        int x;
+        int y;
+        int width;
+    };
+
+    // Height at which a rectangle starting at node `index` rests, if it fits
+    std::optional<int> fit(size_t index, int width, int height) const {
+        int x = m_skyline[index].x;
+        if (x + width > m_width)
+            return std::nullopt;
+
+        int y = 0;
+        int width_left = width;
+        for (size_t i = index; width_left > 0; ++i) {
+            y = std::max(y, m_skyline[i].y);
+            if (y + height > m_height)
+                return std::nullopt;
+            width_left -= m_skyline[i].width;
+        }
+        return y;
+    }
+
+    void addLevel(size_t index, glm::ivec2 position, int width, int height) {
+        m_skyline.insert(m_skyline.begin() + index, {position.x, position.y + height, width});
+
+        // Trim the nodes now covered by the new one
+        for (size_t i = index + 1; i < m_skyline.size();) {
+            const auto& previous = m_skyline[i - 1];
+            auto& node = m_skyline[i];
+            int previous_end = previous.x + previous.width;
+            if (node.x >= previous_end)
+                break;
+
+            int shrink = previous_end - node.x;
+            node.x += shrink;
+            node.width -= shrink;
+            if (node.width > 0)
+                break;
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+
+        // Merge neighbours at the same height
+        for (size_t i = 0; i + 1 < m_skyline.size();) {
+            if (m_skyline[i].y == m_skyline[i + 1].y) {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    int m_width;
+    int m_height;
+    std::vector<Node> m_skyline;
+};
+
+// Copies an image into a page and repeats its edge texels `padding` times around it
+void blit(std::vector<uint8_t>& page, int page_width, const uint8_t* pixels, int width, int height,
+          glm::ivec2 position, int padding) {
+    constexpr size_t texel_size = 4;
+
+    for (int row = -padding; row < height + padding; ++row) {
+        int source_row = std::clamp(row, 0, height - 1);
+        const uint8_t* source = pixels + static_cast<size_t>(source_row) * width * texel_size;
+
+        size_t row_start = static_cast<size_t>(position.y + padding + row) * page_width;
+        uint8_t* destination = page.data() + (row_start + position.x) * texel_size;
+
+        for (int i = 0; i < padding; ++i) {
+            std::memcpy(destination + i * texel_size, source, texel_size);
+            std::memcpy(destination + (padding + width + i) * texel_size,
+                        source + (width - 1) * texel_size, texel_size);
+        }
+        std::memcpy(destination + padding * texel_size, source, width * texel_size);
+    }
+}
+
+} // namespace
+
+TextureAtlas::Builder::Builder(const TextureAtlasSpecification& spec) : m_spec(spec) {}
+
+auto TextureAtlas::Builder::add(const std::filesystem::path& path) -> std::optional<Id> {
+    stbi_set_flip_vertically_on_load(1);
+
+    int width, height, channels;
+    std::string filepath = path.string();
+    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+
+    if (!data) {
+        std::cerr << "Failed to load texture: " << filepath << "\n";
+        return std::nullopt;
+    }
+
+    auto id = add(data, width, height);
+    stbi_image_free(data);
+    return id;
+}
+
+auto TextureAtlas::Builder::add(const uint8_t* rgba, int width, int height) -> std::optional<Id> {
+    if (width + 2 * m_spec.padding > m_spec.page_width ||
+        height + 2 * m_spec.padding > m_spec.page_height) {
+        std::cerr << "Image of " << width << "x" << height << " does not fit an atlas page\n";
+        return std::nullopt;
+    }
+
+    size_t size = static_cast<size_t>(width) * height * 4;
+    m_images.push_back({std::vector<uint8_t>(rgba, rgba + size), width, height});
+    return static_cast<Id>(m_images.size() - 1);
+}
+
+TextureAtlas TextureAtlas::Builder::build() const {
+    // Tallest first keeps the skyline flat
+    std::vector<Id> order(m_images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&](Id a, Id b) {
+        return std::tie(m_images[a].height, m_images[a].width) >
+               std::tie(m_images[b].height, m_images[b].width);
+    });
+
+    struct Page {
+        SkylinePacker packer;
+        std::vector<uint8_t> pixels;
+    };
+    std::vector<Page> pages;
+
+    struct Placement {
+        size_t page;
+        glm::ivec2 position;
+    };
+    std::vector<Placement> placements(m_images.size());
+
+    int padding = m_spec.padding;
+    for (Id id : order) {
+        const auto& image = m_images[id];
+        int width = image.width + 2 * padding;
+        int height = image.height + 2 * padding;
+
+        std::optional<glm::ivec2> position;
+        size_t page = 0;
+        for (; page < pages.size(); ++page) {
+            position = pages[page].packer.insert(width, height);
+            if (position)
+                break;
+        }
+        if (!position) {
+            size_t page_size = static_cast<size_t>(m_spec.page_width) * m_spec.page_height * 4;
+            pages.push_back({SkylinePacker(m_spec.page_width, m_spec.page_height),
+                             std::vector<uint8_t>(page_size, 0)});
+            page = pages.size() - 1;
+            position = pages[page].packer.insert(width, height);
+        }
+
+        blit(pages[page].pixels, m_spec.page_width, image.pixels.data(), image.width,
+             image.height, *position, padding);
+        placements[id] = {page, *position};
+    }
+
+    std::vector<Texture> textures;
+    textures.reserve(pages.size());
+    for (const auto& page : pages) {
+        textures.push_back(
+            Texture::create(page.pixels.data(), m_spec.page_width, m_spec.page_height, 4,
+                            m_spec.texture));
+    }
+
+    glm::vec2 page_size{m_spec.page_width, m_spec.page_height};
+    std::vector<SubTexture> sub_textures;
+    sub_textures.reserve(m_images.size());
+    for (size_t id = 0; id < m_images.size(); ++id) {
+        const auto& image = m_images[id];
+        const auto& placement = placements[id];
+        glm::vec2 min = glm::vec2(placement.position + padding);
+        glm::vec2 max = min + glm::vec2(image.width, image.height);
+        sub_textures.push_back({
+            .texture = &textures[placement.page],
+            .uv_min = min / page_size,
+            .uv_max = max / page_size,
+            .size = {image.width, image.height},
+        });
+    }
+
+    return TextureAtlas(std::move(textures), std::move(sub_textures));
+}
+
+} // namespace mamba::Renderer
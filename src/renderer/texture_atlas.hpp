@@ -0,0 +1,71 @@
+#pragma once
+
+#include "renderer/texture.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace mamba::Renderer {
+
+/// Rectangle of an atlas page, drawn like a texture of its own
+struct SubTexture {
+    const Texture* texture;
+    glm::vec2 uv_min;
+    glm::vec2 uv_max;
+    glm::ivec2 size; // In pixels
+};
+
+struct TextureAtlasSpecification {
+    int page_width = 2048;
+    int page_height = 2048;
+    // Edge texels repeated around each image so filtering never samples a neighbour
+    int padding = 1;
+    // Mips are off by default: they would bleed neighbours into each other once a level's texel
+    // covers more than the padding. Raise the padding before turning them on.
+    TextureSpecification texture{.generate_mips = false, .wrap = TextureWrap::ClampToEdge};
+};
+
+/// Small images packed into a few large pages, so sprites drawn from the same page share one
+/// texture slot in a Renderer2D batch.
+class TextureAtlas {
+  public:
+    using Id = uint32_t;
+
+    class Builder {
+      public:
+        explicit Builder(const TextureAtlasSpecification& spec = {});
+
+        std::optional<Id> add(const std::filesystem::path& path);
+        std::optional<Id> add(const uint8_t* rgba, int width, int height);
+
+        // Packs every added image with a bottom-left skyline packer and uploads the pages
+        TextureAtlas build() const;
+
+      private:
+        struct Image {
+            std::vector<uint8_t> pixels; // RGBA8
+            int width;
+            int height;
+        };
+
+        TextureAtlasSpecification m_spec;
+        std::vector<Image> m_images;
+    };
+
+    const SubTexture& get(Id id) const { return m_sub_textures[id]; }
+    size_t getPageCount() const { return m_pages.size(); }
+
+  private:
+    TextureAtlas(std::vector<Texture>&& pages, std::vector<SubTexture>&& sub_textures)
+        : m_pages(std::move(pages)), m_sub_textures(std::move(sub_textures)) {}
+
+    // Sub-textures point into the page storage, which is never resized after build
+    std::vector<Texture> m_pages;
+    std::vector<SubTexture> m_sub_textures;
+};
+
+} // namespace mamba::Renderer
@@ -0,0 +1,164 @@
+#include "texture_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+
+namespace mamba::Renderer {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+uint64_t fnv1a(std::span<const uint8_t> data, uint64_t hash = FNV_OFFSET) {
+    for (uint8_t byte : data) {
+        hash = (hash ^ byte) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// The same file loaded with different settings is a different texture
+uint64_t specKey(const TextureSpecification& spec) {
+    return static_cast<uint64_t>(spec.generate_mips) | static_cast<uint64_t>(spec.srgb) << 1 |
+           static_cast<uint64_t>(spec.filter) << 2 | static_cast<uint64_t>(spec.wrap) << 4 |
+           static_cast<uint64_t>(std::bit_cast<uint32_t>(spec.anisotropy)) << 32;
+}
+
+// Empty if the file cannot be read
+std::optional<std::vector<uint8_t>> readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (!file || error)
+        return std::nullopt;
+
+    std::vector<uint8_t> data(size);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size)))
+        return std::nullopt;
+    return data;
+}
+
+} // namespace
+
+TextureCache::TextureCache(const TextureCacheSpecification& spec) : m_spec(spec) {}
+
+std::shared_ptr<const Texture> TextureCache::load(const std::filesystem::path& path,
+                                                  const TextureSpecification& spec) {
+    std::error_code error;
+    auto canonical = std::filesystem::weakly_canonical(path, error);
+    PathKey key{(error ? path.lexically_normal() : canonical).string(), specKey(spec)};
+
+    if (auto found = m_by_path.find(key); found != m_by_path.end()) {
+        ++m_hits;
+        return touch(found->second);
+    }
+
+    auto data = readFile(path);
+    if (!data) {
+        std::cerr << "Failed to open texture: " << path.string() << "\n";
+        return nullptr;
+    }
+
+    // Seeding with the settings keeps differently configured copies apart
+    uint64_t content_hash = fnv1a(*data, FNV_OFFSET ^ key.spec);
+
+    // A matching hash only names candidates, the bytes decide. Cached entries do not keep
+    // theirs, so they are read back from the entry's file, which misses if it changed since.
+    auto [first, last] = m_by_content.equal_range(content_hash);
+    for (auto found = first; found != last; ++found) {
+        auto entry = found->second;
+        if (entry->content_size != data->size())
+            continue;
+        auto cached = readFile(entry->paths.front().path);
+        if (!cached || !std::ranges::equal(*cached, *data))
+            continue;
+
+        ++m_hits;
+        entry->paths.push_back(key);
+        m_by_path.emplace(std::move(key), entry);
+        return touch(entry);
+    }
+
+    ++m_misses;
+    auto texture = Texture::createFromMemory(*data, spec);
+    if (!texture) {
+        std::cerr << "Failed to load texture: " << path.string() << "\n";
+        return nullptr;
+    }
+
+    m_memory += texture->memorySize();
+    m_entries.push_front({std::make_shared<const Texture>(std::move(*texture)), content_hash,
+                          data->size(), {key}});
+    m_by_path.emplace(std::move(key), m_entries.begin());
+    m_by_content.emplace(content_hash, m_entries.begin());
+
+    auto result = m_entries.front().texture;
+    evict(m_spec.budget);
+    return result;
+}
+
+std::shared_ptr<const Texture> TextureCache::touch(EntryList::iterator entry) {
+    m_entries.splice(m_entries.begin(), m_entries, entry);
+    return entry->texture;
+}
+
+void TextureCache::evict(size_t budget) {
+    for (auto entry = m_entries.end(); entry != m_entries.begin() && m_memory > budget;) {
+        --entry;
+        if (entry->texture.use_count() > 1)
+            continue;
+
+        for (const auto& key : entry->paths) {
+            m_by_path.erase(key);
+        }
+        // Other entries may share the hash, only this one's mapping goes
+        auto [first, last] = m_by_content.equal_range(entry->content_hash);
+        m_by_content.erase(std::find_if(first, last, [&](const auto& mapping) {
+            return mapping.second == entry;
+        }));
+        m_memory -= entry->texture->memorySize();
+        ++m_evictions;
+        entry = m_entries.erase(entry);
+    }
+}
+
+void TextureCache::trim() { evict(m_spec.budget); }
+
+void TextureCache::clear() { evict(0); }
+
+void TextureCache::setBudget(size_t budget) {
+    m_spec.budget = budget;
+    evict(budget);
+}
+
+TextureCacheStats TextureCache::getStats() const {
+    size_t unused_memory = 0;
+    for (const auto& entry : m_entries) {
+        if (entry.texture.use_count() == 1)
+            unused_memory += entry.texture->memorySize();
+    }
+    return {
+        .textures = m_entries.size(),
+        .memory = m_memory,
+        .unused_memory = unused_memory,
+        .hits = m_hits,
+        .misses = m_misses,
+        .evictions = m_evictions,
+    };
+}
+
+auto TextureCache::getEntries() const -> std::vector<EntryInfo> {
+    std::vector<EntryInfo> entries;
+    entries.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        entries.push_back({entry.paths.front().path, entry.texture->memorySize(),
+                           entry.texture.use_count() - 1});
+    }
+    return entries;
+}
+
+} // namespace mamba::Renderer
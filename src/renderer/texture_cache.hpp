@@ -0,0 +1,101 @@
+#pragma once
+
+#include "renderer/texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mamba::Renderer {
+
+struct TextureCacheSpecification {
+    // VRAM the cache may hold before it starts evicting textures nobody references anymore
+    size_t budget = 256 * 1024 * 1024;
+};
+
+struct TextureCacheStats {
+    size_t textures;
+    size_t memory;        // Bytes held by every cached texture
+    size_t unused_memory; // Bytes held by textures only the cache references
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+/// Shares textures between everything that loads the same file. Entries are found by path
+/// first and by the file contents second, so copies of a file under different names are
+/// uploaded once too. A file that changes on disk keeps its cached texture until evicted.
+class TextureCache {
+  public:
+    struct EntryInfo {
+        std::filesystem::path path;
+        size_t memory;
+        long references; // Handles held outside the cache
+    };
+
+    explicit TextureCache(const TextureCacheSpecification& spec = {});
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Null if the file cannot be read or decoded
+    std::shared_ptr<const Texture> load(const std::filesystem::path& path,
+                                        const TextureSpecification& spec = {});
+
+    // Evicts unused textures, least recently used first, until the budget is met
+    void trim();
+    // Evicts every unused texture
+    void clear();
+
+    void setBudget(size_t budget);
+    size_t getBudget() const { return m_spec.budget; }
+
+    TextureCacheStats getStats() const;
+    // Most recently used first
+    std::vector<EntryInfo> getEntries() const;
+
+  private:
+    struct PathKey {
+        std::string path;
+        uint64_t spec;
+        bool operator==(const PathKey&) const = default;
+    };
+
+    struct PathKeyHash {
+        size_t operator()(const PathKey& key) const {
+            return std::hash<std::string>{}(key.path) ^ std::hash<uint64_t>{}(key.spec);
+        }
+    };
+
+    struct Entry {
+        std::shared_ptr<const Texture> texture;
+        uint64_t content_hash;
+        size_t content_size;
+        std::vector<PathKey> paths;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    std::shared_ptr<const Texture> touch(EntryList::iterator entry);
+    void evict(size_t budget);
+
+    TextureCacheSpecification m_spec;
+
+    // Front is the most recently used entry
+    EntryList m_entries;
+    std::unordered_map<PathKey, EntryList::iterator, PathKeyHash> m_by_path;
+    // Files with different contents can share a hash
+    std::unordered_multimap<uint64_t, EntryList::iterator> m_by_content;
+
+    size_t m_memory{0};
+    uint64_t m_hits{0};
+    uint64_t m_misses{0};
+    uint64_t m_evictions{0};
+};
+
+} // namespace mamba::Renderer
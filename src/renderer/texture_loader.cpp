@@ -0,0 +1,203 @@
+#include "texture_loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "stb_image.h"
+
+namespace mamba::Renderer {
+
+const Texture& TextureHandle::get() const {
+    if (getStatus() == Status::Ready)
+        return *m_state->texture;
+    return *m_state->placeholder;
+}
+
+TextureLoader::TextureLoader(const TextureLoaderSpecification& spec)
+    : m_spec(spec), m_placeholder(Texture::createWhite()) {
+
+    // Every segment needs at least a byte, GL rejects empty buffers
+    m_spec.staging_segments = std::max(m_spec.staging_segments, 1u);
+    m_spec.staging_size = std::max<size_t>(m_spec.staging_size, m_spec.staging_segments);
+    m_segment_fences.resize(m_spec.staging_segments, nullptr);
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_staging_buffer);
+    glNamedBufferStorage(m_staging_buffer, m_spec.staging_size, nullptr, flags);
+    m_staging_memory = static_cast<uint8_t*>(
+        glMapNamedBufferRange(m_staging_buffer, 0, m_spec.staging_size, flags));
+
+    // Without a ring every row is wider than a segment and uploads from client memory
+    if (m_staging_memory) {
+        m_segment_size = m_spec.staging_size / m_spec.staging_segments;
+    } else {
+        std::cerr << "Failed to map a " << m_spec.staging_size
+                  << " byte texture staging buffer, uploading without it\n";
+    }
+
+    for (uint32_t i = 0; i < m_spec.decode_threads; ++i) {
+        m_workers.emplace_back([this](std::stop_token stop) { decodeLoop(stop); });
+    }
+}
+
+TextureLoader::~TextureLoader() {
+    for (auto& worker : m_workers) {
+        worker.request_stop();
+    }
+    m_workers.clear();
+
+    for (auto fence : m_segment_fences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    glUnmapNamedBuffer(m_staging_buffer);
+    glDeleteBuffers(1, &m_staging_buffer);
+}
+
+TextureHandle TextureLoader::load(const std::filesystem::path& path,
+                                  const TextureSpecification& spec) {
+    auto state = std::make_shared<TextureHandle::State>();
+    state->placeholder = &m_placeholder;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back({path, spec, state});
+    }
+    m_condition.notify_one();
+
+    return TextureHandle(std::move(state));
+}
+
+void TextureLoader::decodeLoop(std::stop_token stop) {
+    stbi_set_flip_vertically_on_load_thread(1);
+
+    while (true) {
+        DecodeJob job;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stop, [this] { return !m_jobs.empty(); }))
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        // Nobody is waiting for this texture anymore
+        if (job.state.use_count() == 1)
+            continue;
+
+        // Always decode to RGBA so every row of the staging ring is 4-byte aligned
+        int width, height, channels;
+        std::string filepath = job.path.string();
+        Pixels pixels(stbi_load(filepath.c_str(), &width, &height, &channels, 4),
+                      stbi_image_free);
+
+        if (!pixels) {
+            std::cerr << "Failed to load texture: " << filepath << "\n";
+            job.state->status.store(TextureHandle::Status::Failed, std::memory_order_release);
+            continue;
+        }
+
+        std::lock_guard lock(m_mutex);
+        m_decoded.push_back({std::move(job.state), job.spec, std::move(pixels), width, height});
+    }
+}
+
+void TextureLoader::update() {
+    {
+        std::lock_guard lock(m_mutex);
+        while (!m_decoded.empty()) {
+            m_uploads.push_back({.image = std::move(m_decoded.front())});
+            m_decoded.pop_front();
+        }
+    }
+
+    size_t budget = m_spec.upload_budget;
+    while (!m_uploads.empty() && budget > 0) {
+        auto& upload = m_uploads.front();
+        auto& image = upload.image;
+
+        if (image.state.use_count() == 1) {
+            m_uploads.pop_front();
+            continue;
+        }
+
+        if (!upload.texture) {
+            int levels = image.spec.generate_mips ? mipLevelCount(image.width, image.height) : 1;
+            GLenum format = image.spec.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+            GLuint handle;
+            glCreateTextures(GL_TEXTURE_2D, 1, &handle);
+            glTextureStorage2D(handle, levels, format, image.width, image.height);
+
+            upload.texture = Texture(handle, image.width, image.height, levels, format,
+                                     Texture::getSampler(image.spec, levels > 1));
+        }
+
+        size_t row_size = static_cast<size_t>(image.width) * 4;
+        size_t rows_left = static_cast<size_t>(image.height - upload.next_row);
+        const uint8_t* source = image.pixels.get() + upload.next_row * row_size;
+
+        // Rows wider than a staging segment are uploaded straight from client memory
+        if (row_size > m_segment_size) {
+            glTextureSubImage2D(upload.texture->handle(), 0, 0, upload.next_row, image.width,
+                                static_cast<GLsizei>(rows_left), GL_RGBA, GL_UNSIGNED_BYTE, source);
+            budget -= std::min(budget, rows_left * row_size);
+            finishUpload(upload);
+            m_uploads.pop_front();
+            continue;
+        }
+
+        // The GPU is still reading every segment, try again next frame
+        if (!acquireSegment())
+            break;
+
+        size_t rows = std::min({rows_left, m_segment_size / row_size,
+                                std::max<size_t>(budget / row_size, 1)});
+        size_t offset = m_segment * m_segment_size;
+        std::memcpy(m_staging_memory + offset, source, rows * row_size);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_staging_buffer);
+        glTextureSubImage2D(upload.texture->handle(), 0, 0, upload.next_row, image.width,
+                            static_cast<GLsizei>(rows), GL_RGBA, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(offset));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        m_segment_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_segment = (m_segment + 1) % m_spec.staging_segments;
+
+        budget -= std::min(budget, rows * row_size);
+        upload.next_row += static_cast<int>(rows);
+
+        if (upload.next_row == image.height) {
+            finishUpload(upload);
+            m_uploads.pop_front();
+        }
+    }
+}
+
+bool TextureLoader::acquireSegment() {
+    GLsync& fence = m_segment_fences[m_segment];
+    if (!fence)
+        return true;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    glDeleteSync(fence);
+    fence = nullptr;
+    return true;
+}
+
+void TextureLoader::finishUpload(Upload& upload) {
+    if (upload.texture->levels() > 1)
+        glGenerateTextureMipmap(upload.texture->handle());
+
+    auto& state = *upload.image.state;
+    state.texture = std::move(upload.texture);
+    state.status.store(TextureHandle::Status::Ready, std::memory_order_release);
+}
+
+} // namespace mamba::Renderer
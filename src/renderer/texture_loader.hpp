@@ -0,0 +1,119 @@
+#pragma once
+
+#include "renderer/texture.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace mamba::Renderer {
+
+/// A texture that may still be loading. Usable as soon as TextureLoader::load returns: it
+/// resolves to the loader's placeholder until the image is decoded and fully uploaded.
+class TextureHandle {
+  public:
+    enum class Status { Loading, Ready, Failed };
+
+    const Texture& get() const;
+    Status getStatus() const { return m_state->status.load(std::memory_order_acquire); }
+    bool isReady() const { return getStatus() == Status::Ready; }
+
+  private:
+    friend class TextureLoader;
+
+    struct State {
+        std::atomic<Status> status{Status::Loading};
+        const Texture* placeholder;
+        std::optional<Texture> texture; // Only touched on the GL thread
+    };
+
+    explicit TextureHandle(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+    std::shared_ptr<State> m_state;
+};
+
+struct TextureLoaderSpecification {
+    uint32_t decode_threads = 2;
+    // Persistently mapped pixel unpack ring, split into fenced segments
+    size_t staging_size = 16 * 1024 * 1024;
+    uint32_t staging_segments = 4;
+    // Bytes copied into the ring per update(), larger images stream over several frames
+    size_t upload_budget = 8 * 1024 * 1024;
+};
+
+/// Decodes images on a thread pool and streams them to the GPU from the GL thread.
+class TextureLoader {
+  public:
+    TextureLoader(const TextureLoaderSpecification& spec = {});
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    TextureHandle load(const std::filesystem::path& path, const TextureSpecification& spec = {});
+
+    // Uploads decoded images within the frame budget. Call once per frame on the GL thread.
+    void update();
+
+    const Texture& getPlaceholder() const { return m_placeholder; }
+
+  private:
+    using Pixels = std::unique_ptr<uint8_t, void (*)(void*)>;
+
+    struct DecodeJob {
+        std::filesystem::path path;
+        TextureSpecification spec;
+        std::shared_ptr<TextureHandle::State> state;
+    };
+
+    struct DecodedImage {
+        std::shared_ptr<TextureHandle::State> state;
+        TextureSpecification spec;
+        Pixels pixels;
+        int width;
+        int height;
+    };
+
+    struct Upload {
+        DecodedImage image;
+        std::optional<Texture> texture{};
+        int next_row{0};
+    };
+
+    void decodeLoop(std::stop_token stop);
+    bool acquireSegment();
+    void finishUpload(Upload& upload);
+
+    TextureLoaderSpecification m_spec;
+    Texture m_placeholder;
+
+    // Shared with the decode threads
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<DecodeJob> m_jobs;
+    std::deque<DecodedImage> m_decoded;
+
+    // GL thread only
+    std::deque<Upload> m_uploads;
+    GLuint m_staging_buffer{0};
+    uint8_t* m_staging_memory{nullptr};
+    size_t m_segment_size{0};
+    std::vector<GLsync> m_segment_fences;
+    uint32_t m_segment{0};
+
+    // Last member, so the threads are joined before the queues they use are destroyed
+    std::vector<std::jthread> m_workers;
+};
+
+} // namespace mamba::Renderer
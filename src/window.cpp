@@ -14,7 +14,11 @@
 
 namespace mamba {
 
-Window::Window(const WindowSpecification& spec) : m_event_handler(spec.event_handler) {
+Window::Window(const WindowSpecification& spec)
+    : m_event_handler(spec.event_handler), m_headless(spec.headless) {
+
+    if (m_headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
 
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -25,7 +29,18 @@ Window::Window(const WindowSpecification& spec) : m_event_handler(spec.event_han
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    if (m_headless) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+
     m_handle = glfwCreateWindow(spec.width, spec.height, spec.title.c_str(), nullptr, nullptr);
+    if (!m_handle && m_headless) {
+        // Both run on Mesa's llvmpipe, OSMesa covers builds without EGL
+        std::cerr << "EGL context unavailable, trying OSMesa" << std::endl;
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        m_handle = glfwCreateWindow(spec.width, spec.height, spec.title.c_str(), nullptr, nullptr);
+    }
     if (!m_handle) {
         std::cerr << "Failed to create GLFW window" << std::endl;
         glfwTerminate();
@@ -39,7 +54,10 @@ Window::Window(const WindowSpecification& spec) : m_event_handler(spec.event_han
         glfwTerminate();
     }
 
-    glfwSwapInterval(1);
+    if (!m_headless)
+        setVSync(spec.vsync);
+    else
+        m_vsync = VSyncMode::Off;
 
     glfwSetWindowCloseCallback(m_handle, [](GLFWwindow* handle) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(handle));
@@ -113,9 +131,34 @@ Window::~Window() {
     glfwTerminate();
 }
 
+void Window::setVSync(VSyncMode mode) {
+    // Negative intervals need the swap_control_tear extension of the platform's GL binding
+    if (mode == VSyncMode::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cerr << "Adaptive vsync unsupported, using regular vsync" << std::endl;
+        mode = VSyncMode::On;
+    }
+
+    switch (mode) {
+    case VSyncMode::Off:
+        glfwSwapInterval(0);
+        break;
+    case VSyncMode::On:
+        glfwSwapInterval(1);
+        break;
+    case VSyncMode::Adaptive:
+        glfwSwapInterval(-1);
+        break;
+    }
+    m_vsync = mode;
+}
+
 bool Window::shouldClose() { return glfwWindowShouldClose(m_handle) != 0; }
 
-void Window::update() { glfwSwapBuffers(m_handle); }
+void Window::update() {
+    if (!m_headless)
+        glfwSwapBuffers(m_handle);
+}
 
 void Window::raiseEvent(Event& event) {
     if (m_event_handler)
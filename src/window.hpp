@@ -13,11 +13,23 @@ struct GLFWwindow;
 
 namespace mamba {
 
+enum class VSyncMode {
+    Off,
+    On,
+    // Waits for vertical blank unless the frame is already late, then presents right away
+    // instead of waiting a whole extra refresh. Falls back to On where unsupported.
+    Adaptive,
+};
+
 struct WindowSpecification {
     std::string title;
     uint32_t width;
     uint32_t height;
     std::function<void(Event&)> event_handler;
+    VSyncMode vsync = VSyncMode::On;
+    // No window system: GLFW's null platform with an EGL surfaceless context, or OSMesa where
+    // EGL is unavailable. There is no default framebuffer to draw to or present.
+    bool headless = false;
 };
 
 class Window {
@@ -29,6 +41,9 @@ class Window {
     bool shouldClose();
     void update();
     void raiseEvent(Event&);
+    void setVSync(VSyncMode mode);
+    bool isHeadless() const { return m_headless; }
+    VSyncMode getVSync() const { return m_vsync; }
 
     glm::vec2 getFrameBufferSize() const;
     glm::vec2 getMousePosition() const;
@@ -38,5 +53,7 @@ class Window {
   private:
     GLFWwindow* m_handle;
     std::function<void(Event&)> m_event_handler;
+    VSyncMode m_vsync{VSyncMode::On};
+    bool m_headless{false};
 };
 } // namespace mamba
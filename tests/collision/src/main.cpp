@@ -0,0 +1,283 @@
+// Checks the results of the pair tests in physics/collision.hpp for the edge cases the
+// collision benchmark feeds them: circle centers inside boxes, zero-size boxes, exactly
+// touching edges and zero radius. The benchmark only compares its batched and scalar paths,
+// this pins down what both of them have to return. Raycasts and sweeps are checked for face
+// and corner hits, near misses, starting inside and limits on time.
+
+// Asserts stay on in Release builds, which is what ctest usually runs
+#undef NDEBUG
+#include <cassert>
+
+#include "physics/collision.hpp"
+
+#include <cmath>
+#include <iostream>
+
+using namespace mamba::physics;
+
+namespace {
+
+bool near(float a, float b) { return std::abs(a - b) < 1e-5f; }
+
+bool near(const glm::vec2& a, const glm::vec2& b) { return near(a.x, b.x) && near(a.y, b.y); }
+
+void circleCenterInsideBox() {
+    const AABB box{{0.0f, 0.0f}, {4.0f, 2.0f}};
+
+    // Closer to the top edge than to the right one, pushed out along y
+    const Circle circle{{1.0f, 0.5f}, 0.5f};
+    assert(overlaps(circle, box));
+    assert(overlaps(box, circle));
+    assert(contains(box, circle.center));
+
+    auto info = collides(circle, box);
+    assert(info);
+    assert(near(info->normal, {0.0f, -1.0f}));
+    assert(near(info->penetration, 1.0f)); // 0.5 to the edge plus the radius
+
+    auto reversed = collides(box, circle);
+    assert(reversed);
+    assert(near(reversed->normal, {0.0f, 1.0f}));
+    assert(near(reversed->penetration, 1.0f));
+
+    // Closer to the right edge, pushed out along x
+    info = collides(Circle{{1.75f, 0.0f}, 0.5f}, box);
+    assert(info);
+    assert(near(info->normal, {-1.0f, 0.0f}));
+    assert(near(info->penetration, 0.75f));
+
+    // Exactly at the box center the shorter half extent wins
+    info = collides(Circle{box.center, 0.5f}, box);
+    assert(info);
+    assert(near(info->normal, {0.0f, 1.0f}));
+    assert(near(info->penetration, 1.5f));
+}
+
+void zeroSizeBoxes() {
+    const AABB point_box{{1.0f, 1.0f}, {0.0f, 0.0f}};
+
+    // Two empty boxes at the same spot have no area to share
+    assert(!overlaps(point_box, point_box));
+
+    // An empty box strictly inside another one overlaps it, one on its edge does not
+    assert(overlaps(point_box, AABB{{0.0f, 0.0f}, {4.0f, 4.0f}}));
+    assert(!overlaps(point_box, AABB{{0.0f, 0.0f}, {2.0f, 2.0f}}));
+    assert(!overlaps(point_box, AABB{{5.0f, 5.0f}, {2.0f, 2.0f}}));
+
+    // Containment is inclusive, so an empty box still contains its own center
+    assert(contains(point_box, point_box.center));
+    assert(!contains(point_box, {1.0f, 1.5f}));
+
+    // Against circles it behaves like a point
+    assert(overlaps(Circle{{1.5f, 1.0f}, 1.0f}, point_box));
+    assert(!overlaps(Circle{{3.0f, 1.0f}, 1.0f}, point_box));
+
+    auto info = collides(Circle{{1.5f, 1.0f}, 1.0f}, point_box);
+    assert(info);
+    assert(near(info->normal, {-1.0f, 0.0f}));
+    assert(near(info->penetration, 0.5f));
+}
+
+void touchingEdges() {
+    const AABB box{{0.0f, 0.0f}, {2.0f, 2.0f}};
+
+    // Boxes sharing an edge or only a corner do not overlap, in either order
+    const AABB right{{2.0f, 0.0f}, {2.0f, 2.0f}};
+    const AABB corner{{2.0f, 2.0f}, {2.0f, 2.0f}};
+    assert(!overlaps(box, right));
+    assert(!overlaps(right, box));
+    assert(!overlaps(box, corner));
+
+    // Nudged inside by a little, they do
+    assert(overlaps(box, AABB{{1.99f, 0.0f}, {2.0f, 2.0f}}));
+
+    // Points on the edge and on the corner are contained
+    assert(contains(box, {1.0f, 0.0f}));
+    assert(contains(box, {1.0f, 1.0f}));
+    assert(contains(box, {-1.0f, -1.0f}));
+    assert(!contains(box, {1.01f, 0.0f}));
+
+    // Circles touching each other do not overlap
+    assert(!overlaps(Circle{{0.0f, 0.0f}, 1.0f}, Circle{{2.0f, 0.0f}, 1.0f}));
+    assert(overlaps(Circle{{0.0f, 0.0f}, 1.0f}, Circle{{1.99f, 0.0f}, 1.0f}));
+
+    // A circle touching a box does not overlap it but still collides, with no penetration,
+    // so resolution code sees the contact
+    const Circle touching{{2.0f, 0.0f}, 1.0f};
+    assert(!overlaps(touching, box));
+    auto info = collides(touching, box);
+    assert(info);
+    assert(near(info->normal, {-1.0f, 0.0f}));
+    assert(near(info->penetration, 0.0f));
+    assert(!collides(Circle{{2.01f, 0.0f}, 1.0f}, box));
+
+    // A point on the circle's edge is outside it
+    assert(!contains(touching, {3.0f, 0.0f}));
+    assert(!contains(touching, {2.0f, 1.0f}));
+    assert(contains(touching, {2.99f, 0.0f}));
+}
+
+void zeroRadius() {
+    const AABB box{{0.0f, 0.0f}, {2.0f, 2.0f}};
+    const Circle point{{0.5f, 0.0f}, 0.0f};
+
+    // A circle without area overlaps nothing on its own and contains nothing, not even its
+    // center
+    assert(!overlaps(point, box));
+    assert(!overlaps(point, point));
+    assert(!contains(point, point.center));
+
+    // Inside a larger circle it overlaps, like a point would
+    assert(overlaps(point, Circle{{0.0f, 0.0f}, 1.0f}));
+    assert(!overlaps(point, Circle{{2.0f, 0.0f}, 1.0f}));
+
+    // Collision still reports how far to push it out of the box
+    auto info = collides(point, box);
+    assert(info);
+    assert(near(info->normal, {-1.0f, 0.0f}));
+    assert(near(info->penetration, 0.5f));
+
+    // On the edge it touches with no penetration, outside it misses
+    info = collides(Circle{{1.0f, 0.5f}, 0.0f}, box);
+    assert(info);
+    assert(near(info->penetration, 0.0f));
+    assert(!collides(Circle{{1.5f, 0.0f}, 0.0f}, box));
+}
+
+void raycastBox() {
+    const AABB box{{0.0f, 0.0f}, {2.0f, 2.0f}};
+
+    // Straight into the left face
+    auto hit = raycast(Ray{{-3.0f, 0.0f}, {4.0f, 0.0f}}, box);
+    assert(hit);
+    assert(near(hit->time, 0.5f));
+    assert(near(hit->normal, {-1.0f, 0.0f}));
+
+    // Diagonally into the top face
+    hit = raycast(Ray{{0.0f, 3.0f}, {1.0f, -4.0f}}, box);
+    assert(hit);
+    assert(near(hit->time, 0.5f));
+    assert(near(hit->normal, {0.0f, 1.0f}));
+
+    // Passing the top right corner on the outside
+    assert(!raycast(Ray{{0.0f, 2.5f}, {2.0f, -2.0f}}, box));
+
+    // Parallel to a face outside the box, and moving away from it
+    assert(!raycast(Ray{{-3.0f, 2.0f}, {4.0f, 0.0f}}, box));
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {-4.0f, 0.0f}}, box));
+
+    // Starting inside never hits, not even the face the ray leaves through
+    assert(!raycast(Ray{{0.0f, 0.0f}, {4.0f, 0.0f}}, box));
+
+    // The hit lies beyond max_time unless it is raised
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {1.0f, 0.0f}}, box));
+    hit = raycast(Ray{{-3.0f, 0.0f}, {1.0f, 0.0f}}, box, 3.0f);
+    assert(hit);
+    assert(near(hit->time, 2.0f));
+
+    // A ray that does not move only hits what it starts in, which does not count
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {0.0f, 0.0f}}, box));
+}
+
+void raycastCircle() {
+    const Circle circle{{0.0f, 0.0f}, 1.0f};
+
+    auto hit = raycast(Ray{{-3.0f, 0.0f}, {4.0f, 0.0f}}, circle);
+    assert(hit);
+    assert(near(hit->time, 0.5f));
+    assert(near(hit->normal, {-1.0f, 0.0f}));
+
+    // Off center, the normal points from the center to the contact
+    hit = raycast(Ray{{-3.0f, 0.6f}, {4.0f, 0.0f}}, circle);
+    assert(hit);
+    assert(near(hit->time, 0.55f));
+    assert(near(hit->normal, {-0.8f, 0.6f}));
+
+    // Just above the top of the circle, and moving away from it
+    assert(!raycast(Ray{{-3.0f, 1.01f}, {4.0f, 0.0f}}, circle));
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {-4.0f, 0.0f}}, circle));
+
+    assert(!raycast(Ray{{0.5f, 0.0f}, {4.0f, 0.0f}}, circle));
+
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {1.0f, 0.0f}}, circle));
+    hit = raycast(Ray{{-3.0f, 0.0f}, {1.0f, 0.0f}}, circle, 3.0f);
+    assert(hit);
+    assert(near(hit->time, 2.0f));
+
+    assert(!raycast(Ray{{-3.0f, 0.0f}, {0.0f, 0.0f}}, circle));
+
+    // A circle without radius is hit only dead on, the normal faces the ray
+    hit = raycast(Ray{{-3.0f, 0.0f}, {4.0f, 0.0f}}, Circle{{0.0f, 0.0f}, 0.0f});
+    assert(hit);
+    assert(near(hit->time, 0.75f));
+    assert(near(hit->normal, {-1.0f, 0.0f}));
+    assert(!raycast(Ray{{-3.0f, 0.01f}, {4.0f, 0.0f}}, Circle{{0.0f, 0.0f}, 0.0f}));
+}
+
+void sweepCircle() {
+    const AABB box{{0.0f, 0.0f}, {2.0f, 2.0f}};
+
+    // Into the left face, touching once the center is a radius away
+    auto hit = sweep(Circle{{-3.0f, 0.0f}, 0.5f}, {4.0f, 0.0f}, box);
+    assert(hit);
+    assert(near(hit->time, 0.375f));
+    assert(near(hit->normal, {-1.0f, 0.0f}));
+
+    // Entering the grown box next to the top left corner, the rounded corner is hit later
+    hit = sweep(Circle{{-3.0f, 1.3f}, 0.5f}, {4.0f, 0.0f}, box);
+    assert(hit);
+    assert(near(hit->time, 0.4f));
+    assert(near(hit->normal, {-0.8f, 0.6f}));
+
+    // Starting next to the corner, already inside the grown box but not touching
+    hit = sweep(Circle{{-1.4f, 1.4f}, 0.5f}, {1.0f, -1.0f}, box);
+    assert(hit);
+    assert(hit->time > 0.0f && hit->time < 0.1f);
+    assert(near(hit->normal, glm::normalize(glm::vec2{-1.0f, 1.0f})));
+
+    // Passing the corner diagonally 0.6 away: crosses the grown box, misses the rounded corner
+    assert(!sweep(Circle{{-4.0f, -1.1515f}, 0.5f}, {4.0f, 4.0f}, box));
+    // The same path 0.4 away hits it
+    assert(sweep(Circle{{-4.0f, -1.4343f}, 0.5f}, {4.0f, 4.0f}, box));
+
+    // Already overlapping hits at time 0, the normal points from the box to the circle
+    hit = sweep(Circle{{0.9f, 0.0f}, 0.5f}, {4.0f, 0.0f}, box);
+    assert(hit);
+    assert(hit->time == 0.0f);
+    assert(near(hit->normal, {1.0f, 0.0f}));
+    hit = sweep(Circle{{1.3f, 0.0f}, 0.5f}, {-4.0f, 0.0f}, box);
+    assert(hit);
+    assert(hit->time == 0.0f);
+    assert(near(hit->normal, {1.0f, 0.0f}));
+
+    // Without velocity only an existing overlap hits
+    assert(!sweep(Circle{{-3.0f, 0.0f}, 0.5f}, {0.0f, 0.0f}, box));
+    assert(!sweep(Circle{{-1.4f, 1.4f}, 0.5f}, {0.0f, 0.0f}, box));
+    hit = sweep(Circle{{0.9f, 0.0f}, 0.5f}, {0.0f, 0.0f}, box);
+    assert(hit);
+    assert(hit->time == 0.0f);
+
+    // A circle without radius sweeps like a ray
+    hit = sweep(Circle{{-3.0f, 0.0f}, 0.0f}, {4.0f, 0.0f}, box);
+    assert(hit);
+    assert(near(hit->time, 0.5f));
+    assert(near(hit->normal, {-1.0f, 0.0f}));
+
+    // Contact beyond the end of the step
+    assert(!sweep(Circle{{-3.0f, 0.0f}, 0.5f}, {1.0f, 0.0f}, box));
+    assert(!sweep(Circle{{-3.0f, 0.0f}, 0.5f}, {-4.0f, 0.0f}, box));
+}
+
+} // namespace
+
+int main() {
+    circleCenterInsideBox();
+    zeroSizeBoxes();
+    touchingEdges();
+    zeroRadius();
+    raycastBox();
+    raycastCircle();
+    sweepCircle();
+    std::cout << "collision_test: all checks passed\n";
+    return 0;
+}
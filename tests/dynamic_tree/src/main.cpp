@@ -0,0 +1,308 @@
+// Checks physics/dynamic_tree.hpp: id reuse across insert, update, remove and clear, queries
+// against brute force over the fat boxes after random moves and removals, casts clipped
+// through the callback's return value, and the tree's height after sorted inserts.
+
+// Asserts stay on in Release builds, which is what ctest usually runs
+#undef NDEBUG
+#include <cassert>
+
+#include "physics/collision.hpp"
+#include "physics/dynamic_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace mamba::physics;
+
+namespace {
+
+using Id = DynamicTree::Id;
+
+float uniform(std::mt19937& rng, float min, float max) {
+    return min + (max - min) * static_cast<float>(rng()) / static_cast<float>(rng.max());
+}
+
+AABB randomBox(std::mt19937& rng) {
+    return {{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)},
+            {uniform(rng, 0.5f, 8.0f), uniform(rng, 0.5f, 8.0f)}};
+}
+
+std::vector<Id> sorted(std::vector<Id> ids) {
+    std::ranges::sort(ids);
+    return ids;
+}
+
+void idsAndUpdates() {
+    DynamicTree tree;
+    assert(tree.size() == 0);
+    assert(tree.getHeight() == 0);
+
+    Id a = tree.insert(AABB{{0.0f, 0.0f}, {2.0f, 2.0f}}, 10);
+    Id b = tree.insert(AABB{{10.0f, 10.0f}, {2.0f, 2.0f}}, 11);
+    Id c = tree.insert(Circle{{20.0f, 0.0f}, 1.0f}, 12);
+    assert(tree.size() == 3);
+    assert(a != b && b != c && a != c);
+    assert(tree.getUserData(b) == 11);
+    assert(tree.getUserData(c) == 12);
+
+    // Fat boxes hold the tight box plus the margin on every side
+    AABB fat = tree.getFatBounds(a);
+    assert(std::abs(fat.size.x - 2.2f) < 1e-5f && std::abs(fat.size.y - 2.2f) < 1e-5f);
+
+    // Small moves stay inside the fat box, larger ones reinsert the leaf under the same id
+    assert(!tree.update(a, AABB{{0.05f, 0.0f}, {2.0f, 2.0f}}));
+    assert(tree.update(a, AABB{{5.0f, 0.0f}, {2.0f, 2.0f}}, {1.0f, 0.0f}));
+    assert(tree.getUserData(a) == 10);
+    // Stretched along the displacement: the margin behind, margin plus 4 times it in front
+    fat = tree.getFatBounds(a);
+    assert(std::abs(fat.center.x - fat.size.x / 2.0f - 3.9f) < 1e-5f);
+    assert(std::abs(fat.center.x + fat.size.x / 2.0f - 10.1f) < 1e-5f);
+
+    // A removed leaf's id goes to the next insert
+    tree.remove(b);
+    assert(tree.size() == 2);
+    Id d = tree.insert(AABB{{30.0f, 0.0f}, {2.0f, 2.0f}}, 13);
+    assert(d == b);
+    assert(tree.getUserData(d) == 13);
+    std::vector<Id> found;
+    tree.query(AABB{{10.0f, 10.0f}, {2.0f, 2.0f}}, found);
+    assert(found.empty());
+    tree.query(AABB{{30.0f, 0.0f}, {1.0f, 1.0f}}, found);
+    assert(found == std::vector<Id>{d});
+
+    // Removing every leaf leaves an empty tree that still accepts inserts
+    tree.remove(a);
+    tree.remove(c);
+    tree.remove(d);
+    assert(tree.size() == 0);
+    assert(tree.getHeight() == 0);
+    found.clear();
+    tree.query(AABB{{0.0f, 0.0f}, {100.0f, 100.0f}}, found);
+    assert(found.empty());
+    tree.insert(AABB{{0.0f, 0.0f}, {1.0f, 1.0f}});
+    assert(tree.size() == 1);
+
+    // Ids start at 0 again after clear
+    tree.clear();
+    assert(tree.size() == 0);
+    found.clear();
+    tree.query(AABB{{0.0f, 0.0f}, {100.0f, 100.0f}}, found);
+    assert(found.empty());
+    assert(tree.insert(AABB{{0.0f, 0.0f}, {1.0f, 1.0f}}) == 0);
+}
+
+void queriesMatchBruteForce() {
+    std::mt19937 rng(0x74726565);
+    DynamicTree tree;
+    std::vector<AABB> boxes;
+    std::vector<std::optional<Id>> ids; // Per box, empty once removed
+
+    for (int i = 0; i < 500; ++i) {
+        boxes.push_back(randomBox(rng));
+        ids.push_back(tree.insert(boxes.back(), static_cast<uint32_t>(i)));
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        // Move some boxes a little and some far, remove a few and insert replacements
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (!ids[i])
+                continue;
+            uint32_t roll = rng() % 100;
+            if (roll < 30) {
+                glm::vec2 step{uniform(rng, -0.5f, 0.5f), uniform(rng, -0.5f, 0.5f)};
+                boxes[i].center += step;
+                tree.update(*ids[i], boxes[i], step);
+            } else if (roll < 35) {
+                boxes[i] = randomBox(rng);
+                tree.update(*ids[i], boxes[i]);
+            } else if (roll < 37) {
+                tree.remove(*ids[i]);
+                ids[i].reset();
+            }
+        }
+        for (int i = 0; i < 10; ++i) {
+            boxes.push_back(randomBox(rng));
+            ids.push_back(tree.insert(boxes.back(), static_cast<uint32_t>(boxes.size() - 1)));
+        }
+
+        auto live = std::ranges::count_if(ids, &std::optional<Id>::has_value);
+        assert(tree.size() == static_cast<size_t>(live));
+
+        for (int i = 0; i < 50; ++i) {
+            AABB region{{uniform(rng, -10.0f, 110.0f), uniform(rng, -10.0f, 110.0f)},
+                        {uniform(rng, 0.0f, 30.0f), uniform(rng, 0.0f, 30.0f)}};
+            glm::vec2 point{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)};
+
+            std::vector<Id> expected_region, expected_point;
+            for (size_t box = 0; box < boxes.size(); ++box) {
+                if (!ids[box])
+                    continue;
+                Id id = *ids[box];
+                AABB fat = tree.getFatBounds(id);
+                // The fat box always covers the real one
+                assert(contains(fat, boxes[box].center - boxes[box].size / 2.0f));
+                assert(contains(fat, boxes[box].center + boxes[box].size / 2.0f));
+                assert(tree.getUserData(id) == box);
+                if (overlaps(fat, region))
+                    expected_region.push_back(id);
+                if (contains(fat, point))
+                    expected_point.push_back(id);
+            }
+
+            std::vector<Id> found;
+            tree.query(region, found);
+            assert(sorted(found) == sorted(expected_region));
+
+            found.clear();
+            tree.query(point, [&](Id id) { found.push_back(id); });
+            assert(sorted(found) == sorted(expected_point));
+        }
+    }
+}
+
+void castsClipThroughCallback() {
+    // A row of boxes along x, and a few off to the side the cast never reaches
+    DynamicTree tree;
+    std::vector<AABB> boxes;
+    for (int i = 0; i < 10; ++i)
+        boxes.push_back({{4.0f + 3.0f * static_cast<float>(i), 0.0f}, {1.0f, 2.0f}});
+    for (int i = 0; i < 10; ++i)
+        boxes.push_back({{4.0f + 3.0f * static_cast<float>(i), 20.0f}, {1.0f, 2.0f}});
+    for (uint32_t i = 0; i < boxes.size(); ++i)
+        tree.insert(boxes[i], i);
+
+    const glm::vec2 origin{0.0f, 0.0f};
+    const glm::vec2 translation{40.0f, 0.0f};
+    const Ray ray{origin, translation};
+
+    // Ignoring every leaf reports each one the segment crosses, once
+    std::vector<uint32_t> crossed;
+    tree.raycast(origin, translation, [&](Id id, float max_fraction) {
+        assert(max_fraction == 1.0f);
+        crossed.push_back(tree.getUserData(id));
+        return max_fraction;
+    });
+    std::ranges::sort(crossed);
+    assert((crossed == std::vector<uint32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // Clipping to each hit ends at the closest box. Leaves whose fat box starts past the
+    // clipped end of the segment are not reported anymore.
+    float closest = 1.0f;
+    size_t calls = 0;
+    tree.raycast(origin, translation, [&](Id id, float max_fraction) {
+        ++calls;
+        assert(max_fraction == closest);
+        AABB fat = tree.getFatBounds(id);
+        assert(fat.center.x - fat.size.x / 2.0f <= max_fraction * translation.x);
+        auto hit = raycast(ray, boxes[tree.getUserData(id)], max_fraction);
+        if (!hit)
+            return max_fraction;
+        closest = hit->time;
+        return hit->time;
+    });
+    assert(std::abs(closest - 3.5f / 40.0f) < 1e-5f);
+    assert(calls >= 1 && calls <= crossed.size());
+
+    // Returning 0 stops at the first leaf
+    calls = 0;
+    tree.raycast(origin, translation, [&](Id, float) {
+        ++calls;
+        return 0.0f;
+    });
+    assert(calls == 1);
+
+    // A segment that ends before the first box, or passes above the row, reports nothing
+    auto count = [&](glm::vec2 from, glm::vec2 by) {
+        size_t reported = 0;
+        tree.raycast(from, by, [&](Id, float max_fraction) {
+            ++reported;
+            return max_fraction;
+        });
+        return reported;
+    };
+    assert(count(origin, {3.0f, 0.0f}) == 0);
+    assert(count({0.0f, 1.5f}, translation) == 0);
+
+    // Casting shapes along the same segment finds the closest of their sweeps
+    auto closestOf = [&](auto&& time_of) {
+        float best = 1.0f;
+        for (const auto& box : boxes) {
+            if (auto time = time_of(box, 1.0f))
+                best = std::min(best, *time);
+        }
+        return best;
+    };
+
+    // The circle passes above the row but overlaps it, which a ray from its center misses
+    const Circle circle{{0.0f, 1.5f}, 0.75f};
+    auto sweep_time = [&](const AABB& box, float max_fraction) -> std::optional<float> {
+        auto hit = sweep(circle, translation, box);
+        if (!hit || hit->time > max_fraction)
+            return std::nullopt;
+        return hit->time;
+    };
+    float circle_closest = 1.0f;
+    tree.shapeCast(circle, translation, [&](Id id, float max_fraction) {
+        auto time = sweep_time(boxes[tree.getUserData(id)], max_fraction);
+        if (!time)
+            return max_fraction;
+        circle_closest = *time;
+        return *time;
+    });
+    assert(circle_closest < 1.0f);
+    assert(circle_closest == closestOf(sweep_time));
+
+    // A box cast is a ray against boxes grown by the shape's half size
+    const AABB shape{{0.0f, -1.2f}, {1.0f, 1.0f}};
+    auto box_time = [&](const AABB& box, float max_fraction) -> std::optional<float> {
+        auto hit = raycast(Ray{shape.center, translation},
+                           AABB{box.center, box.size + shape.size}, max_fraction);
+        return hit ? std::optional(hit->time) : std::nullopt;
+    };
+    float box_closest = 1.0f;
+    tree.shapeCast(shape, translation, [&](Id id, float max_fraction) {
+        auto time = box_time(boxes[tree.getUserData(id)], max_fraction);
+        if (!time)
+            return max_fraction;
+        box_closest = *time;
+        return *time;
+    });
+    assert(std::abs(box_closest - 3.0f / 40.0f) < 1e-5f);
+    assert(box_closest == closestOf(box_time));
+}
+
+void heightAfterSortedInserts() {
+    // Sorted inserts always extend the same edge, without rotations the tree becomes a list
+    constexpr int COUNT = 1024;
+    DynamicTree tree;
+    std::vector<Id> ids;
+    for (int i = 0; i < COUNT; ++i)
+        ids.push_back(tree.insert(AABB{{static_cast<float>(i) * 2.0f, 0.0f}, {1.0f, 1.0f}}));
+
+    // A perfectly balanced tree of 1024 leaves has height 10, rotations keep it close
+    assert(tree.getHeight() >= 10);
+    assert(tree.getHeight() <= 15);
+
+    // Removing the first half, again in order, keeps it balanced as well
+    for (int i = 0; i < COUNT / 2; ++i)
+        tree.remove(ids[i]);
+    assert(tree.getHeight() >= 9);
+    assert(tree.getHeight() <= 14);
+}
+
+} // namespace
+
+int main() {
+    idsAndUpdates();
+    queriesMatchBruteForce();
+    castsClipThroughCallback();
+    heightAfterSortedInserts();
+    std::cout << "dynamic_tree_test: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Checks that Shader::reflect marks every kind of sampler uniform as a sampler, integer and
+// shadow samplers included, which Material::setTexture relies on. Needs an OpenGL 4.6
+// context, created headless the same way Window does; without one the test is skipped.
+
+// Asserts stay on in Release builds, which is what ctest usually runs
+#undef NDEBUG
+#include <cassert>
+
+#include "renderer/shader.hpp"
+
+#include <iostream>
+#include <string_view>
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+using namespace mamba::Renderer;
+
+namespace {
+
+constexpr int SKIPPED = 77;
+
+constexpr std::string_view VERTEX_SOURCE = R"(#version 460 core
+void main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); }
+)";
+
+// Every uniform feeds the output, unused ones would not be active
+constexpr std::string_view FRAGMENT_SOURCE = R"(#version 460 core
+uniform sampler2D uColor;
+uniform isampler2DArray uIndices;
+uniform usampler3D uMask;
+uniform sampler2DArrayShadow uShadow;
+uniform samplerCubeArray uProbes;
+uniform sampler2D uTextures[4];
+uniform float uScale;
+out vec4 fragColor;
+void main() {
+    vec4 color = texture(uColor, vec2(0.5));
+    for (int i = 0; i < 4; ++i)
+        color += texture(uTextures[i], vec2(0.5));
+    color.r += float(texture(uIndices, vec3(0.5)).r);
+    color.g += float(texture(uMask, vec3(0.5)).r);
+    color.b += texture(uShadow, vec4(0.5));
+    color += texture(uProbes, vec4(0.0, 0.0, 1.0, 0.0));
+    fragColor = color * uScale;
+}
+)";
+
+GLFWwindow* createContext() {
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit())
+        return nullptr;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "shader_test", nullptr, nullptr);
+    if (!window) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(1, 1, "shader_test", nullptr, nullptr);
+    }
+    if (!window)
+        return nullptr;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        glfwDestroyWindow(window);
+        return nullptr;
+    }
+    return window;
+}
+
+void checkSampler(const Shader& shader, std::string_view name, GLenum type) {
+    const auto* uniform = shader.findUniform(name);
+    assert(uniform);
+    assert(uniform->type == type);
+    assert(uniform->sampler);
+}
+
+void reflectSamplers() {
+    auto shader = Shader::createFromSource(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    if (!shader) {
+        std::cerr << shader.error() << "\n";
+        assert(false);
+    }
+
+    checkSampler(*shader, "uColor", GL_SAMPLER_2D);
+    checkSampler(*shader, "uIndices", GL_INT_SAMPLER_2D_ARRAY);
+    checkSampler(*shader, "uMask", GL_UNSIGNED_INT_SAMPLER_3D);
+    checkSampler(*shader, "uShadow", GL_SAMPLER_2D_ARRAY_SHADOW);
+    checkSampler(*shader, "uProbes", GL_SAMPLER_CUBE_MAP_ARRAY);
+
+    // Arrays are reachable by their plain name
+    checkSampler(*shader, "uTextures", GL_SAMPLER_2D);
+    assert(shader->findUniform("uTextures")->array_size == 4);
+
+    const auto* scale = shader->findUniform("uScale");
+    assert(scale);
+    assert(!scale->sampler);
+}
+
+} // namespace
+
+int main() {
+    GLFWwindow* window = createContext();
+    if (!window) {
+        std::cout << "shader_test: no OpenGL 4.6 context, skipped\n";
+        glfwTerminate();
+        return SKIPPED;
+    }
+
+    reflectSamplers();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << "shader_test: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,255 @@
+// Checks physics/sweep_and_prune.hpp: the pairs added and removed by every updatePairs against
+// the difference of brute force pair sets, for touching edges, removals followed by inserts
+// within one update, bulk inserts that take the full rebuild and random frames of moves,
+// removals and inserts.
+
+// Asserts stay on in Release builds, which is what ctest usually runs
+#undef NDEBUG
+#include <cassert>
+
+#include "physics/collision.hpp"
+#include "physics/sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace mamba::physics;
+
+namespace {
+
+using Id = SweepAndPrune::Id;
+using Pair = SweepAndPrune::Pair;
+
+float uniform(std::mt19937& rng, float min, float max) {
+    return min + (max - min) * static_cast<float>(rng()) / static_cast<float>(rng.max());
+}
+
+AABB randomBox(std::mt19937& rng) {
+    return {{uniform(rng, 0.0f, 100.0f), uniform(rng, 0.0f, 100.0f)},
+            {uniform(rng, 0.5f, 8.0f), uniform(rng, 0.5f, 8.0f)}};
+}
+
+std::vector<Pair> sorted(std::vector<Pair> pairs) {
+    std::ranges::sort(pairs, {}, [](const Pair& pair) { return std::pair(pair.a, pair.b); });
+    return pairs;
+}
+
+// Mirrors the broadphase's boxes by id and checks every update against brute force
+class Checker {
+  public:
+    Id insert(const AABB& box) {
+        Id id = m_broadphase.insert(box);
+        if (id >= m_boxes.size())
+            m_boxes.resize(id + 1);
+        // Ids of removed colliders are only reused after the next updatePairs
+        assert(!m_boxes[id] && !m_removed_ids.contains(id));
+        m_boxes[id] = box;
+        return id;
+    }
+
+    void update(Id id, const AABB& box) {
+        m_broadphase.update(id, box);
+        m_boxes[id] = box;
+    }
+
+    void remove(Id id) {
+        m_broadphase.remove(id);
+        m_boxes[id].reset();
+        m_removed_ids.insert(id);
+    }
+
+    // Runs updatePairs and returns the number of pair changes it reported
+    size_t updatePairs() {
+        m_broadphase.updatePairs();
+        m_removed_ids.clear();
+
+        std::vector<Pair> pairs;
+        for (Id a = 0; a < m_boxes.size(); ++a) {
+            for (Id b = a + 1; b < m_boxes.size(); ++b) {
+                if (m_boxes[a] && m_boxes[b] && overlaps(*m_boxes[a], *m_boxes[b]))
+                    pairs.push_back({a, b});
+            }
+        }
+
+        std::vector<Pair> added, removed;
+        std::ranges::set_difference(pairs, m_pairs, std::back_inserter(added), less);
+        std::ranges::set_difference(m_pairs, pairs, std::back_inserter(removed), less);
+        assert(sorted(m_broadphase.getAddedPairs()) == added);
+        assert(sorted(m_broadphase.getRemovedPairs()) == removed);
+
+        std::vector<Pair> reported;
+        m_broadphase.forEachPair([&](Id a, Id b) {
+            assert(a < b);
+            reported.push_back({a, b});
+        });
+        assert(sorted(reported) == pairs);
+        assert(m_broadphase.getPairCount() == pairs.size());
+        auto alive = std::ranges::count_if(m_boxes, &std::optional<AABB>::has_value);
+        assert(m_broadphase.size() == static_cast<size_t>(alive));
+
+        m_pairs = std::move(pairs);
+        return added.size() + removed.size();
+    }
+
+    const std::optional<AABB>& box(Id id) const { return m_boxes[id]; }
+    size_t idCount() const { return m_boxes.size(); }
+    const std::vector<Pair>& added() const { return m_broadphase.getAddedPairs(); }
+    const std::vector<Pair>& removed() const { return m_broadphase.getRemovedPairs(); }
+
+  private:
+    static bool less(const Pair& a, const Pair& b) {
+        return std::pair(a.a, a.b) < std::pair(b.a, b.b);
+    }
+
+    SweepAndPrune m_broadphase;
+    std::vector<std::optional<AABB>> m_boxes;
+    std::vector<Pair> m_pairs; // Sorted, as of the last updatePairs
+    std::unordered_set<Id> m_removed_ids;
+};
+
+void touchingEdges() {
+    Checker checker;
+    // Unit boxes: b right of a, c above a, and d left of c, touching a at a corner
+    Id a = checker.insert({{0.0f, 0.0f}, {1.0f, 1.0f}});
+    Id b = checker.insert({{1.0f, 0.0f}, {1.0f, 1.0f}});
+    Id c = checker.insert({{0.0f, 1.0f}, {1.0f, 1.0f}});
+    Id d = checker.insert({{-1.0f, 1.0f}, {1.0f, 1.0f}});
+    assert(checker.updatePairs() == 0);
+
+    // Overlapping by a little is a pair, moving back to touching ends it
+    checker.update(b, {{0.99f, 0.0f}, {1.0f, 1.0f}});
+    checker.updatePairs();
+    assert((checker.added() == std::vector<Pair>{{a, b}}));
+    checker.update(b, {{1.0f, 0.0f}, {1.0f, 1.0f}});
+    checker.updatePairs();
+    assert((checker.removed() == std::vector<Pair>{{a, b}}));
+
+    checker.update(c, {{0.0f, 0.99f}, {1.0f, 1.0f}});
+    checker.updatePairs();
+    assert((checker.added() == std::vector<Pair>{{a, c}}));
+
+    // Sliding down the left edges of c and a keeps touching them without ever overlapping
+    for (int i = 0; i < 8; ++i) {
+        checker.update(d, {{-1.0f, 1.0f - 0.25f * static_cast<float>(i)}, {1.0f, 1.0f}});
+        assert(checker.updatePairs() == 0);
+    }
+    assert(checker.box(d)->center.y < -0.5f);
+
+    // Identical boxes overlap
+    AABB copy = *checker.box(a);
+    Id e = checker.insert(copy);
+    checker.updatePairs();
+    assert(sorted(checker.added()) == (std::vector<Pair>{{a, e}, {c, e}}));
+}
+
+void removeThenInsertInOneUpdate() {
+    Checker checker;
+    Id a = checker.insert({{0.0f, 0.0f}, {2.0f, 2.0f}});
+    Id b = checker.insert({{1.0f, 0.0f}, {2.0f, 2.0f}});
+    for (int i = 0; i < 8; ++i)
+        checker.insert({{10.0f + 3.0f * static_cast<float>(i), 0.0f}, {1.0f, 1.0f}});
+    checker.updatePairs();
+    assert((checker.added() == std::vector<Pair>{{a, b}}));
+
+    // The new collider lands where the removed one was and gets a fresh id, the update reports
+    // the old pair as removed and the new one as added
+    checker.remove(a);
+    Id c = checker.insert({{0.0f, 0.0f}, {2.0f, 2.0f}});
+    assert(c != a);
+    checker.updatePairs();
+    assert((checker.removed() == std::vector<Pair>{{a, b}}));
+    assert((checker.added() == std::vector<Pair>{{b, c}}));
+
+    // The removed id is free after the update
+    checker.remove(b);
+    Id d = checker.insert({{0.5f, 0.0f}, {2.0f, 2.0f}});
+    assert(d == a);
+    checker.updatePairs();
+    assert((checker.removed() == std::vector<Pair>{{b, c}}));
+    assert((checker.added() == std::vector<Pair>{{a, c}}));
+
+    // Inserted and removed before any update, never reported
+    Id e = checker.insert({{0.0f, 0.0f}, {2.0f, 2.0f}});
+    checker.remove(e);
+    assert(checker.updatePairs() == 0);
+}
+
+void bulkInsertsRebuild() {
+    std::mt19937 rng(0x73617031);
+    Checker checker;
+    for (int i = 0; i < 100; ++i)
+        checker.insert(randomBox(rng));
+    checker.updatePairs();
+
+    // 60 inserts among 150 colliders take the full rebuild, with moves and removals in the
+    // same update
+    for (int i = 0; i < 60; ++i)
+        checker.insert(randomBox(rng));
+    for (Id id = 0; id < 20; ++id)
+        checker.update(id, randomBox(rng));
+    for (Id id = 20; id < 30; ++id)
+        checker.remove(id);
+    assert(checker.updatePairs() > 0);
+
+    // A few inserts go through the insertion sort again
+    for (int i = 0; i < 5; ++i)
+        checker.insert(randomBox(rng));
+    checker.update(40, randomBox(rng));
+    checker.remove(41);
+    checker.updatePairs();
+
+    // Removing everything and inserting a new batch reports every old pair as removed
+    for (Id id = 0; id < checker.idCount(); ++id) {
+        if (checker.box(id))
+            checker.remove(id);
+    }
+    for (int i = 0; i < 50; ++i)
+        checker.insert(randomBox(rng));
+    checker.updatePairs();
+}
+
+void randomFrames() {
+    std::mt19937 rng(0x73617032);
+    Checker checker;
+    for (int i = 0; i < 300; ++i)
+        checker.insert(randomBox(rng));
+    checker.updatePairs();
+
+    size_t changes = 0;
+    for (int frame = 0; frame < 50; ++frame) {
+        for (Id id = 0; id < checker.idCount(); ++id) {
+            const auto& box = checker.box(id);
+            if (!box || rng() % 4 != 0)
+                continue;
+            glm::vec2 offset{uniform(rng, -1.5f, 1.5f), uniform(rng, -1.5f, 1.5f)};
+            checker.update(id, {box->center + offset, box->size});
+        }
+        for (int i = 0; i < 3; ++i) {
+            Id id = static_cast<Id>(rng() % checker.idCount());
+            if (checker.box(id))
+                checker.remove(id);
+        }
+        for (int i = 0; i < 3; ++i)
+            checker.insert(randomBox(rng));
+        changes += checker.updatePairs();
+    }
+    assert(changes > 0);
+}
+
+} // namespace
+
+int main() {
+    touchingEdges();
+    removeThenInsertInOneUpdate();
+    bulkInsertsRebuild();
+    randomFrames();
+    std::cout << "sweep_and_prune_test: all checks passed\n";
+    return 0;
+}
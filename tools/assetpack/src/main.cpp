@@ -0,0 +1,60 @@
+// Packs every file under a directory into one asset pack. Assets are named by their path
+// relative to that directory, with forward slashes on every platform.
+//
+// Usage: assetpack <directory> <output.pack> [--compress]
+
+#include "assets/asset_pack.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (argc == 4 && std::string_view(argv[3]) != "--compress") || argc > 4) {
+        std::cerr << "Usage: assetpack <directory> <output.pack> [--compress]\n";
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    bool compress = argc == 4;
+
+    std::error_code error;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator(root, error)) {
+        if (entry.is_regular_file())
+            files.push_back(entry.path());
+    }
+    if (error) {
+        std::cerr << "Failed to read " << root.string() << ": " << error.message() << "\n";
+        return 1;
+    }
+    // Stable output for identical inputs
+    std::ranges::sort(files);
+
+    mamba::assets::AssetPack::Builder builder;
+    size_t total = 0;
+    for (const auto& path : files) {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> data(fs::file_size(path));
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            std::cerr << "Failed to read " << path.string() << "\n";
+            return 1;
+        }
+
+        builder.add(fs::relative(path, root).generic_string(), data, compress);
+        total += data.size();
+    }
+
+    if (!builder.write(argv[2]))
+        return 1;
+
+    std::cout << files.size() << " assets, " << total << " bytes -> " << fs::file_size(argv[2])
+              << " bytes\n";
+    return 0;
+}
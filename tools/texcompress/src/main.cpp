@@ -0,0 +1,373 @@
+// Offline texture compressor. Decodes an image with stb_image, builds its mip chain and writes
+// BC1 (opaque) or BC3 (with alpha) blocks into a KTX2 file that Texture::create uploads as is.
+//
+// Usage: texcompress <input> <output.ktx2> [--bc1 | --bc3] [--srgb] [--no-mips]
+
+#include "renderer/ktx2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "stb_image.h"
+
+using namespace mamba::Renderer;
+
+namespace {
+
+struct Image {
+    std::vector<uint8_t> pixels; // RGBA8, bottom row first
+    int width;
+    int height;
+};
+
+using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+// Box filters a level down to the next one, odd edges repeat their last texel
+Image downsample(const Image& image) {
+    Image result{{}, std::max(image.width / 2, 1), std::max(image.height / 2, 1)};
+    result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+    auto texel = [&](int x, int y) {
+        x = std::min(x, image.width - 1);
+        y = std::min(y, image.height - 1);
+        return image.pixels.data() + (static_cast<size_t>(y) * image.width + x) * 4;
+    };
+
+    for (int y = 0; y < result.height; ++y) {
+        for (int x = 0; x < result.width; ++x) {
+            const uint8_t* samples[4] = {texel(2 * x, 2 * y), texel(2 * x + 1, 2 * y),
+                                         texel(2 * x, 2 * y + 1), texel(2 * x + 1, 2 * y + 1)};
+            uint8_t* out = result.pixels.data() + (static_cast<size_t>(y) * result.width + x) * 4;
+            for (int c = 0; c < 4; ++c) {
+                int sum = samples[0][c] + samples[1][c] + samples[2][c] + samples[3][c];
+                out[c] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+Block fetchBlock(const Image& image, int block_x, int block_y) {
+    Block block;
+    for (int i = 0; i < 16; ++i) {
+        int x = std::min(block_x * 4 + i % 4, image.width - 1);
+        int y = std::min(block_y * 4 + i / 4, image.height - 1);
+        std::memcpy(block[i].data(),
+                    image.pixels.data() + (static_cast<size_t>(y) * image.width + x) * 4, 4);
+    }
+    return block;
+}
+
+uint16_t to565(const std::array<int, 3>& color) {
+    return static_cast<uint16_t>((color[0] >> 3) << 11 | (color[1] >> 2) << 5 | color[2] >> 3);
+}
+
+std::array<int, 3> from565(uint16_t color) {
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+// Color half of a BC1/BC3 block. Endpoints span the bounding box of the block, inset by a
+// sixteenth of its extent so the interpolated colors land closer to the actual texels.
+void encodeColor(const Block& block, uint8_t* out) {
+    std::array<int, 3> min{255, 255, 255};
+    std::array<int, 3> max{0, 0, 0};
+    for (const auto& texel : block) {
+        for (int c = 0; c < 3; ++c) {
+            min[c] = std::min<int>(min[c], texel[c]);
+            max[c] = std::max<int>(max[c], texel[c]);
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        int inset = (max[c] - min[c]) >> 4;
+        min[c] += inset;
+        max[c] -= inset;
+    }
+
+    // max >= min on every channel, so color0 >= color1 and the block uses four colors
+    uint16_t color0 = to565(max);
+    uint16_t color1 = to565(min);
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        auto c0 = from565(color0);
+        auto c1 = from565(color1);
+        std::array<std::array<int, 3>, 4> palette;
+        for (int c = 0; c < 3; ++c) {
+            palette[0][c] = c0[c];
+            palette[1][c] = c1[c];
+            palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+            palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            uint32_t best = 0;
+            int best_distance = INT32_MAX;
+            for (uint32_t p = 0; p < 4; ++p) {
+                int distance = 0;
+                for (int c = 0; c < 3; ++c) {
+                    int d = block[i][c] - palette[p][c];
+                    distance += d * d;
+                }
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = p;
+                }
+            }
+            indices |= best << (2 * i);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(color0);
+    out[1] = static_cast<uint8_t>(color0 >> 8);
+    out[2] = static_cast<uint8_t>(color1);
+    out[3] = static_cast<uint8_t>(color1 >> 8);
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+}
+
+// Alpha half of a BC3 block, eight levels between the block's extremes
+void encodeAlpha(const Block& block, uint8_t* out) {
+    int alpha0 = 0;
+    int alpha1 = 255;
+    for (const auto& texel : block) {
+        alpha0 = std::max<int>(alpha0, texel[3]);
+        alpha1 = std::min<int>(alpha1, texel[3]);
+    }
+
+    uint64_t indices = 0;
+    if (alpha0 != alpha1) {
+        std::array<int, 8> palette{alpha0, alpha1};
+        for (int i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            uint64_t best = 0;
+            int best_distance = INT32_MAX;
+            for (uint64_t p = 0; p < 8; ++p) {
+                int distance = std::abs(block[i][3] - palette[p]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = p;
+                }
+            }
+            indices |= best << (3 * i);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(alpha0);
+    out[1] = static_cast<uint8_t>(alpha1);
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+}
+
+std::vector<uint8_t> compress(const Image& image, bool alpha) {
+    int blocks_x = (image.width + 3) / 4;
+    int blocks_y = (image.height + 3) / 4;
+    size_t block_size = alpha ? 16 : 8;
+
+    std::vector<uint8_t> data(static_cast<size_t>(blocks_x) * blocks_y * block_size);
+    uint8_t* out = data.data();
+    for (int y = 0; y < blocks_y; ++y) {
+        for (int x = 0; x < blocks_x; ++x) {
+            Block block = fetchBlock(image, x, y);
+            if (alpha) {
+                encodeAlpha(block, out);
+                encodeColor(block, out + 8);
+            } else {
+                encodeColor(block, out);
+            }
+            out += block_size;
+        }
+    }
+    return data;
+}
+
+// Basic data format descriptor the KTX2 spec requires, one sample per 64 bit block half
+std::vector<uint32_t> dataFormatDescriptor(bool alpha, bool srgb) {
+    constexpr uint32_t MODEL_BC1A = 128;
+    constexpr uint32_t MODEL_BC3 = 130;
+    constexpr uint32_t CHANNEL_COLOR = 0;
+    constexpr uint32_t CHANNEL_ALPHA = 15;
+    constexpr uint32_t QUALIFIER_LINEAR = 0x10;
+
+    uint32_t samples = alpha ? 2 : 1;
+    uint32_t block_size = 24 + 16 * samples;
+    uint32_t transfer = srgb ? 2 : 1;
+
+    std::vector<uint32_t> words{
+        4 + block_size,
+        0,                    // Khronos vendor, basic descriptor type
+        2 | block_size << 16, // Version 2
+        (alpha ? MODEL_BC3 : MODEL_BC1A) | 1 << 8 | transfer << 16, // BT.709 primaries
+        3 | 3 << 8,           // 4x4 texel blocks
+        alpha ? 16u : 8u,     // Bytes in plane 0
+        0,
+    };
+
+    auto add_sample = [&](uint32_t bit_offset, uint32_t channel) {
+        words.insert(words.end(), {bit_offset | 63 << 16 | channel << 24, 0, 0, UINT32_MAX});
+    };
+    if (alpha) {
+        add_sample(0, CHANNEL_ALPHA | (srgb ? QUALIFIER_LINEAR : 0));
+        add_sample(64, CHANNEL_COLOR);
+    } else {
+        add_sample(0, CHANNEL_COLOR);
+    }
+    return words;
+}
+
+std::vector<uint8_t> keyValueData() {
+    std::vector<uint8_t> data;
+    auto add = [&](std::string_view key, std::string_view value) {
+        auto length = static_cast<uint32_t>(key.size() + value.size() + 2);
+        data.insert(data.end(), reinterpret_cast<const uint8_t*>(&length),
+                    reinterpret_cast<const uint8_t*>(&length) + 4);
+        data.insert(data.end(), key.begin(), key.end());
+        data.push_back(0);
+        data.insert(data.end(), value.begin(), value.end());
+        data.push_back(0);
+        data.resize((data.size() + 3) & ~size_t{3});
+    };
+    // Rows are stored bottom first, matching the flipped loads of every other texture
+    add("KTXorientation", "ru");
+    add("KTXwriter", "mamba texcompress");
+    return data;
+}
+
+bool writeKtx2(const std::string& path, const std::vector<std::vector<uint8_t>>& levels,
+               int width, int height, bool alpha, bool srgb) {
+    auto dfd = dataFormatDescriptor(alpha, srgb);
+    auto kvd = keyValueData();
+    size_t level_count = levels.size();
+    size_t alignment = alpha ? 16 : 8;
+
+    size_t dfd_offset = Ktx2::LEVEL_INDEX_OFFSET + level_count * sizeof(Ktx2::LevelIndex);
+    size_t kvd_offset = dfd_offset + dfd.size() * sizeof(uint32_t);
+    size_t offset = kvd_offset + kvd.size();
+
+    // Levels are stored smallest first, each aligned to the block size
+    std::vector<Ktx2::LevelIndex> level_index(level_count);
+    for (size_t level = level_count; level-- > 0;) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        level_index[level] = {offset, levels[level].size(), levels[level].size()};
+        offset += levels[level].size();
+    }
+
+    Ktx2::Header header{
+        .vk_format = alpha ? (srgb ? Ktx2::BC3_SRGB : Ktx2::BC3_UNORM)
+                           : (srgb ? Ktx2::BC1_RGB_SRGB : Ktx2::BC1_RGB_UNORM),
+        .type_size = 1,
+        .pixel_width = static_cast<uint32_t>(width),
+        .pixel_height = static_cast<uint32_t>(height),
+        .pixel_depth = 0,
+        .layer_count = 0,
+        .face_count = 1,
+        .level_count = static_cast<uint32_t>(level_count),
+        .supercompression_scheme = 0,
+        .dfd_byte_offset = static_cast<uint32_t>(dfd_offset),
+        .dfd_byte_length = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t)),
+        .kvd_byte_offset = static_cast<uint32_t>(kvd_offset),
+        .kvd_byte_length = static_cast<uint32_t>(kvd.size()),
+    };
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(file.data(), Ktx2::IDENTIFIER.data(), Ktx2::IDENTIFIER.size());
+    std::memcpy(file.data() + Ktx2::IDENTIFIER.size(), &header, sizeof(header));
+    std::memcpy(file.data() + Ktx2::LEVEL_INDEX_OFFSET, level_index.data(),
+                level_count * sizeof(Ktx2::LevelIndex));
+    std::memcpy(file.data() + dfd_offset, dfd.data(), dfd.size() * sizeof(uint32_t));
+    std::memcpy(file.data() + kvd_offset, kvd.data(), kvd.size());
+    for (size_t level = 0; level < level_count; ++level) {
+        std::memcpy(file.data() + level_index[level].byte_offset, levels[level].data(),
+                    levels[level].size());
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()),
+              static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: texcompress <input> <output.ktx2> [--bc1 | --bc3] [--srgb] "
+                     "[--no-mips]\n";
+        return 1;
+    }
+
+    enum class Mode { Auto, BC1, BC3 } mode = Mode::Auto;
+    bool srgb = false;
+    bool mips = true;
+    for (int i = 3; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--bc1") {
+            mode = Mode::BC1;
+        } else if (arg == "--bc3") {
+            mode = Mode::BC3;
+        } else if (arg == "--srgb") {
+            srgb = true;
+        } else if (arg == "--no-mips") {
+            mips = false;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    stbi_set_flip_vertically_on_load(1);
+    int width, height, channels;
+    unsigned char* data = stbi_load(argv[1], &width, &height, &channels, 4);
+    if (!data) {
+        std::cerr << "Failed to load image: " << argv[1] << "\n";
+        return 1;
+    }
+
+    Image image{{data, data + static_cast<size_t>(width) * height * 4}, width, height};
+    stbi_image_free(data);
+
+    bool alpha = mode == Mode::BC3;
+    if (mode == Mode::Auto) {
+        for (size_t i = 3; i < image.pixels.size(); i += 4) {
+            if (image.pixels[i] != 255) {
+                alpha = true;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> levels;
+    levels.push_back(compress(image, alpha));
+    while (mips && (image.width > 1 || image.height > 1)) {
+        image = downsample(image);
+        levels.push_back(compress(image, alpha));
+    }
+
+    if (!writeKtx2(argv[2], levels, width, height, alpha, srgb)) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+
+    size_t size = 0;
+    for (const auto& level : levels) {
+        size += level.size();
+    }
+    std::cout << argv[1] << ": " << width << "x" << height << " " << (alpha ? "BC3" : "BC1")
+              << ", " << levels.size() << " levels, " << size << " bytes\n";
+    return 0;
+}